@@ -41,7 +41,7 @@ struct BitMap : public MetaSet<NativeNaturalType, _ParentType> {
     NativeIntegerType fillSlice(NativeNaturalType address, NativeNaturalType length, NativeNaturalType& sliceOffset) {
         NativeIntegerType slicesAdded = 0;
         NativeNaturalType endAddress = address+length, sliceIndex,
-                          frontSliceIndex, sliceLength, sliceAddress;
+                          frontSliceIndex = 0, sliceLength = 0, sliceAddress;
         bool frontSlice = getSliceContaining<false, true>(address, sliceIndex), backSlice = false;
         if(frontSlice) {
             sliceOffset = address-getSliceBeginAddress(sliceIndex);
@@ -99,7 +99,7 @@ struct BitMap : public MetaSet<NativeNaturalType, _ParentType> {
             sliceOffset += Super::getChildBegin(sliceIndex);
             Super::decreaseSize(sliceOffset, sliceLength, sliceIndex);
             if(splitFrontSlice) {
-                Super::setValueAt(sliceIndex+1, sliceOffset);
+                Super::setChildBegin(sliceIndex+1, sliceOffset);
                 return slicesAdded;
             }
             ++sliceIndex;
@@ -199,13 +199,13 @@ struct BitMap : public MetaSet<NativeNaturalType, _ParentType> {
             if(sliceIndex < Super::getElementCount() && getSliceEndAddress(sliceIndex) > srcAddress+length) {
                 NativeNaturalType spareLength = getSliceEndAddress(sliceIndex)-(srcAddress+length);
                 Super::insertElementAt(sliceIndex+1, getSliceBeginAddress(sliceIndex)+spareLength);
-                Super::setValueAt(sliceIndex+1, Super::getChildBegin(sliceIndex)+spareLength);
+                Super::setChildBegin(sliceIndex+1, Super::getChildBegin(sliceIndex)+spareLength);
             }
         } else {
             if(getSliceContaining<true, false>(srcAddress, sliceIndex) && getSliceBeginAddress(sliceIndex) < srcAddress) {
                 NativeNaturalType spareLength = srcAddress-getSliceBeginAddress(sliceIndex);
                 Super::insertElementAt(sliceIndex+1, getSliceEndAddress(sliceIndex)-spareLength);
-                Super::setValueAt(sliceIndex+1, Super::getChildEnd(sliceIndex)-spareLength);
+                Super::setChildBegin(sliceIndex+1, Super::getChildEnd(sliceIndex)-spareLength);
                 ++sliceIndex;
             }
         }
@@ -251,7 +251,7 @@ struct BitMap : public MetaSet<NativeNaturalType, _ParentType> {
                 Super::increaseSize(sliceOffset, length, sliceIndex);
                 while(++sliceIndex < Super::getElementCount()) {
                     Super::setKeyAt(sliceIndex, getSliceBeginAddress(sliceIndex)+length);
-                    Super::setValueAt(sliceIndex+1, Super::getChildBegin(sliceIndex+1)+length);
+                    Super::setChildBegin(sliceIndex+1, Super::getChildBegin(sliceIndex+1)+length);
                 }
                 return;
             } else
@@ -269,7 +269,7 @@ struct BitMap : public MetaSet<NativeNaturalType, _ParentType> {
             Super::decreaseSize(Super::getChildBegin(sliceIndex)+address-getSliceBeginAddress(sliceIndex), length, sliceIndex);
             while(++sliceIndex < Super::getElementCount()) {
                 Super::setKeyAt(sliceIndex, getSliceBeginAddress(sliceIndex)-length);
-                Super::setValueAt(sliceIndex+1, Super::getChildBegin(sliceIndex+1)-length);
+                Super::setChildBegin(sliceIndex+1, Super::getChildBegin(sliceIndex+1)-length);
             }
         } else
             moveSlice(address, address+length, getSliceEndAddress(Super::getElementCount()-1)-address);
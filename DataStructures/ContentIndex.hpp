@@ -3,27 +3,60 @@
 bool unlink(Symbol symbol);
 
 template<typename _ParentType = BitVectorContainer>
-struct ContentIndex : public Set<Symbol, VoidType, _ParentType> {
+struct ContentIndex : public Set<Symbol, Pair<NativeNaturalType, NativeNaturalType>, _ParentType> {
     typedef _ParentType ParentType;
-    typedef Set<Symbol, VoidType, ParentType> Super;
+    typedef Pair<NativeNaturalType, NativeNaturalType> InlineKeyType;
+    typedef Set<Symbol, InlineKeyType, ParentType> Super;
     typedef typename Super::ElementType ElementType;
 
     ContentIndex(ParentType& _parent, NativeNaturalType _childIndex = 0) :Super(_parent, _childIndex) { }
 
-    bool findKey(Symbol key, NativeNaturalType& at) {
-        auto symbolSpace = Super::parent.getBitVector().location.symbolSpace;
-        at = binarySearch<NativeNaturalType>(0, Super::getElementCount(), [&](NativeNaturalType at) {
-            return BitVector(BitVectorLocation(symbolSpace, key)).compare(BitVector(BitVectorLocation(symbolSpace, Super::getElementAt(at)))) < 0;
+    static InlineKeyType getInlineKey(BitVector bitVector) {
+        InlineKeyType inlineKey(bitVector.getSize(), 0);
+        if(inlineKey.first > 0)
+            bitVector.template externalOperate<false>(&inlineKey.second, 0, min(inlineKey.first, static_cast<NativeNaturalType>(architectureSize)));
+        return inlineKey;
+    }
+
+    NativeIntegerType compareAt(NativeNaturalType at, BitVector bitVector, InlineKeyType inlineKey) {
+        InlineKeyType otherInlineKey = Super::getValueAt(at);
+        if(otherInlineKey.first != inlineKey.first)
+            return (otherInlineKey.first < inlineKey.first) ? -1 : 1;
+        if(otherInlineKey.second != inlineKey.second)
+            return (otherInlineKey.second < inlineKey.second) ? -1 : 1;
+        if(inlineKey.first <= architectureSize)
+            return 0;
+        return BitVector(BitVectorLocation(bitVector.location.symbolSpace, Super::getKeyAt(at))).compare(bitVector);
+    }
+
+    bool findContent(BitVector bitVector, InlineKeyType inlineKey, NativeNaturalType& at) {
+        NativeNaturalType elementCount = Super::getElementCount();
+        at = binarySearch<NativeNaturalType>(0, elementCount, [&](NativeNaturalType at) {
+            return compareAt(at, bitVector, inlineKey) < 0;
         });
-        return (at < Super::getElementCount() && Super::getKeyAt(at) == key);
+        return (at < elementCount && compareAt(at, bitVector, inlineKey) == 0);
     }
 
-    void insertElement(Symbol& element) {
+    bool findKey(Symbol key, NativeNaturalType& at) {
+        BitVector bitVector(BitVectorLocation(Super::parent.getBitVector().location.symbolSpace, key));
+        return findContent(bitVector, getInlineKey(bitVector), at);
+    }
+
+    bool insertContent(Symbol& element) {
         NativeNaturalType at;
-        if(findKey(element, at)) {
-            unlink(element);
-            element = Super::getElementAt(at);
-        } else
-            Super::insertElementAt(at, element);
+        BitVector bitVector(BitVectorLocation(Super::parent.getBitVector().location.symbolSpace, element));
+        InlineKeyType inlineKey = getInlineKey(bitVector);
+        if(findContent(bitVector, inlineKey, at)) {
+            element = Super::getKeyAt(at);
+            return false;
+        }
+        Super::insertElementAt(at, ElementType(element, inlineKey));
+        return true;
+    }
+
+    void insertElement(Symbol& element) {
+        Symbol symbol = element;
+        if(!insertContent(element))
+            unlink(symbol);
     }
 };
@@ -71,8 +71,14 @@ void swapElementsAt(Container& container, NativeNaturalType a, NativeNaturalType
 
 template<typename Container>
 void iterateElements(Container& container, Closure<void(typename Container::ElementType)> callback) {
-    for(NativeNaturalType at = 0; at < container.getElementCount(); ++at)
-        callback(container.getElementAt(at));
+    typename Container::ElementType elements[architectureSize];
+    for(NativeNaturalType at = 0; at < container.getElementCount(); ) {
+        NativeNaturalType count = min(container.getElementCount()-at, static_cast<NativeNaturalType>(architectureSize));
+        container.getElements(at, count, elements);
+        for(NativeNaturalType index = 0; index < count; ++index)
+            callback(elements[index]);
+        at += count;
+    }
 }
 
 template<typename Container>
@@ -12,7 +12,13 @@ struct Heap : public PairVector<KeyType, ValueType, _ParentType> {
     usingRemappedMethod(eraseLastElement)
 
     bool compare(NativeNaturalType atA, NativeNaturalType atB) {
-        return SortDirection::compare(Super::getKeyAt(atA), Super::getKeyAt(atB));
+        KeyType keyA, keyB;
+        NativeNaturalType offsetA = Super::getOffsetOfKey(atA), offsetB = Super::getOffsetOfKey(atB);
+        BitVectorOperation<false> reads[2];
+        reads[offsetA > offsetB] = {&keyA, offsetA, sizeOfInBits<KeyType>::value};
+        reads[offsetA <= offsetB] = {&keyB, offsetB, sizeOfInBits<KeyType>::value};
+        assert(Super::getBitVector().externalOperateBatch(reads, 2));
+        return SortDirection::compare(keyA, keyB);
     }
 
     void siftToRoot(NativeNaturalType at) {
@@ -66,7 +72,7 @@ struct Heap : public PairVector<KeyType, ValueType, _ParentType> {
         Super::eraseElementAt(last);
         if(at != last) {
             if(at == 0 || compare(parent, at))
-                siftToLeaves(at, elementCount);
+                siftToLeaves(at, last);
             else
                 siftToRoot(at);
         }
@@ -1,6 +1,8 @@
 #include <DataStructures/Set.hpp>
 
-template<typename KeyType, typename _ParentType = BitVectorContainer>
+// The values are the absolute child begins, or with fenwickTree a Fenwick tree over the header length
+// followed by the lengths of all but the last child, which trades O(log n) lookups for O(log n) resizes
+template<typename KeyType, typename _ParentType = BitVectorContainer, bool fenwickTree = false>
 struct MetaVector : public PairVector<KeyType, NativeNaturalType, _ParentType> {
     typedef _ParentType ParentType;
     typedef PairVector<KeyType, NativeNaturalType, ParentType> Super;
@@ -28,27 +30,30 @@ struct MetaVector : public PairVector<KeyType, NativeNaturalType, _ParentType> {
     }
 
     void insertRange(NativeNaturalType at, NativeNaturalType elementCount) {
-        NativeNaturalType newElementCount = getElementCount()+elementCount,
-                          value = getChildBegin(at);
+        NativeNaturalType oldElementCount = getElementCount(),
+                          value = getChildBegin(at),
+                          shift = elementCount*sizeOfInBits<ElementType>::value;
+        decodeChildBegins(at, oldElementCount);
         Super::insertRange(at, elementCount);
-        for(NativeNaturalType atEnd = at+elementCount; at < atEnd; ++at)
-            Super::setValueAt(at, value);
-        for(NativeNaturalType at = 0; at < newElementCount; ++at)
-            Super::setValueAt(at, Super::getValueAt(at)+elementCount*sizeOfInBits<ElementType>::value);
+        for(NativeNaturalType atEnd = at+elementCount, index = at; index < atEnd; ++index)
+            Super::setValueAt(index, value);
+        addToChildBegins(0, shift, at);
+        encodeChildBegins(at, oldElementCount+elementCount, shift);
     }
 
     template<bool childrenAsWell = true>
     void eraseRange(NativeNaturalType at, NativeNaturalType elementCount) {
-        NativeNaturalType newElementCount = getElementCount()-elementCount,
-                          sliceLength = getChildEnd(at+elementCount-1)-getChildBegin(at);
+        NativeNaturalType oldElementCount = getElementCount(),
+                          sliceLength = getChildEnd(at+elementCount-1)-getChildBegin(at),
+                          shift = elementCount*sizeOfInBits<ElementType>::value;
         if(childrenAsWell)
             Super::parent.decreaseSize(getChildOffset(at), sliceLength, Super::childIndex);
+        else
+            sliceLength = 0;
+        decodeChildBegins(at, oldElementCount);
         Super::eraseRange(at, elementCount);
-        for(NativeNaturalType at = 0; at < newElementCount; ++at)
-            Super::setValueAt(at, Super::getValueAt(at)-elementCount*sizeOfInBits<ElementType>::value);
-        if(childrenAsWell)
-            for(; at < newElementCount; ++at)
-                Super::setValueAt(at, Super::getValueAt(at)-sliceLength);
+        addToChildBegins(0, -shift, at);
+        encodeChildBegins(at, oldElementCount-elementCount, -shift-sliceLength);
     }
 
     void insertElementAt(NativeNaturalType at, KeyType key) {
@@ -63,32 +68,34 @@ struct MetaVector : public PairVector<KeyType, NativeNaturalType, _ParentType> {
     bool moveElementAt(NativeNaturalType dstAt, NativeNaturalType srcAt) {
         if(dstAt == srcAt)
             return false;
-        bool upward = (dstAt > srcAt);
-        if(upward)
-            ++dstAt;
-        NativeNaturalType srcOffset = getChildOffset(srcAt), length = getChildLength(srcAt);
-        insertElementAt(dstAt, Super::getKeyAt(srcAt));
-        NativeNaturalType dstOffset = getChildOffset(dstAt);
-        increaseSize(dstOffset, length, dstAt);
-        Super::getBitVector().interoperation(Super::getBitVector(), dstOffset, srcOffset, length);
-        if(!upward)
-            ++srcAt;
-        eraseElementAt(srcAt);
+        NativeNaturalType srcBegin = getChildBegin(srcAt), length = getChildLength(srcAt),
+                          dstBegin = (dstAt > srcAt) ? getChildEnd(dstAt)-length : getChildBegin(dstAt),
+                          elementCount = getElementCount(), lowestAt = min(dstAt, srcAt);
+        decodeChildBegins(lowestAt, elementCount);
+        if(length > 0) {
+            if(dstAt > srcAt)
+                for(NativeNaturalType at = srcAt+1; at <= dstAt; ++at)
+                    Super::setValueAt(at, Super::getValueAt(at)-length);
+            else
+                for(NativeNaturalType at = dstAt; at < srcAt; ++at)
+                    Super::setValueAt(at, Super::getValueAt(at)+length);
+            NativeNaturalType childOffset = Super::parent.getChildOffset(Super::childIndex);
+            Super::getBitVector().moveSlice(childOffset+dstBegin, childOffset+srcBegin, length);
+        }
+        Super::setValueAt(srcAt, dstBegin);
+        Super::moveElementAt(dstAt, srcAt);
+        encodeChildBegins(lowestAt, elementCount, 0);
         return true;
     }
 
-
-
     void increaseSize(NativeNaturalType offset, NativeNaturalType length, NativeNaturalType at) {
         Super::parent.increaseSize(offset, length, Super::childIndex);
-        for(++at; at < getElementCount(); ++at)
-            Super::setValueAt(at, Super::getValueAt(at)+length);
+        addToChildBegins(at+1, length, getElementCount());
     }
 
     void decreaseSize(NativeNaturalType offset, NativeNaturalType length, NativeNaturalType at) {
         Super::parent.decreaseSize(offset, length, Super::childIndex);
-        for(++at; at < getElementCount(); ++at)
-            Super::setValueAt(at, Super::getValueAt(at)-length);
+        addToChildBegins(at+1, -length, getElementCount());
     }
 
     NativeNaturalType getChildOffset(NativeNaturalType at) {
@@ -98,22 +105,72 @@ struct MetaVector : public PairVector<KeyType, NativeNaturalType, _ParentType> {
     NativeNaturalType getChildBegin(NativeNaturalType at) {
         if(at == getElementCount())
             return Super::parent.getChildLength(Super::childIndex);
-        return Super::getValueAt(at);
+        if(!fenwickTree)
+            return Super::getValueAt(at);
+        NativeNaturalType begin = 0;
+        for(++at; at > 0; at &= at-1)
+            begin += Super::getValueAt(at-1);
+        return begin;
     }
 
     NativeNaturalType getChildEnd(NativeNaturalType at) {
-        if(at+1 == getElementCount())
-            return Super::parent.getChildLength(Super::childIndex);
-        return Super::getValueAt(at+1);
+        return getChildBegin(at+1);
     }
 
     NativeNaturalType getChildLength(NativeNaturalType at) {
         return getChildEnd(at)-getChildBegin(at);
     }
+
+    void setChildBegin(NativeNaturalType at, NativeNaturalType begin) {
+        NativeNaturalType elementCount = getElementCount();
+        if(!fenwickTree) {
+            if(at < elementCount)
+                Super::setValueAt(at, begin);
+            return;
+        }
+        NativeNaturalType length = begin-getChildBegin(at);
+        addToChildBegins(at, length, elementCount);
+        addToChildBegins(at+1, -length, elementCount);
+    }
+
+    void addToChildBegins(NativeNaturalType at, NativeNaturalType length, NativeNaturalType elementCount) {
+        if(!fenwickTree) {
+            for(; at < elementCount; ++at)
+                Super::setValueAt(at, Super::getValueAt(at)+length);
+            return;
+        }
+        for(++at; at <= elementCount; at += at&(~at+1))
+            Super::setValueAt(at-1, Super::getValueAt(at-1)+length);
+    }
+
+    // Turns the values from at onward into absolute child begins
+    void decodeChildBegins(NativeNaturalType at, NativeNaturalType elementCount) {
+        if(!fenwickTree)
+            return;
+        for(NativeNaturalType index = at; index < elementCount; ++index) {
+            NativeNaturalType lower = index&(index+1);
+            if(lower > 0)
+                Super::setValueAt(index, Super::getValueAt(index)+((lower > at) ? Super::getValueAt(lower-1) : getChildBegin(lower-1)));
+        }
+    }
+
+    // Shifts the absolute child begins from at onward and turns them back into the layout
+    void encodeChildBegins(NativeNaturalType at, NativeNaturalType elementCount, NativeNaturalType shift) {
+        if(!fenwickTree) {
+            if(shift != 0)
+                addToChildBegins(at, shift, elementCount);
+            return;
+        }
+        for(NativeNaturalType index = elementCount; index > at; ) {
+            --index;
+            NativeNaturalType lower = index&(index+1);
+            Super::setValueAt(index, Super::getValueAt(index)+shift-((lower == 0) ? 0 : (lower > at) ? Super::getValueAt(lower-1)+shift : getChildBegin(lower-1)));
+        }
+    }
 };
 
-template<typename KeyType, typename _ParentType = BitVectorContainer>
-struct MetaSet : public SetTemplate<MetaVector<KeyType, _ParentType>, KeyType, VoidType, _ParentType> {
-    typedef SetTemplate<MetaVector<KeyType, _ParentType>, KeyType, VoidType, _ParentType> Super;
+template<typename KeyType, typename _ParentType = BitVectorContainer, bool fenwickTree = false>
+struct MetaSet : public SetTemplate<MetaVector<KeyType, _ParentType, fenwickTree>, KeyType, VoidType, _ParentType> {
+    typedef SetTemplate<MetaVector<KeyType, _ParentType, fenwickTree>, KeyType, VoidType, _ParentType> Super;
     using Super::Super;
 };
@@ -1,10 +1,10 @@
 #include <DataStructures/MetaVector.hpp>
 
-template<typename FirstKeyType, typename SecondKeyType, typename _ParentType = BitVectorContainer>
-struct PairSet : public MetaSet<FirstKeyType, _ParentType> {
+template<typename FirstKeyType, typename SecondKeyType, typename _ParentType = BitVectorContainer, bool fenwickTree = false>
+struct PairSet : public MetaSet<FirstKeyType, _ParentType, fenwickTree> {
     typedef _ParentType ParentType;
-    typedef Set<SecondKeyType, VoidType, PairSet<FirstKeyType, SecondKeyType, ParentType>> ValueType;
-    typedef MetaSet<FirstKeyType, ParentType> Super;
+    typedef Set<SecondKeyType, VoidType, PairSet<FirstKeyType, SecondKeyType, ParentType, fenwickTree>> ValueType;
+    typedef MetaSet<FirstKeyType, ParentType, fenwickTree> Super;
     typedef Pair<FirstKeyType, SecondKeyType> ElementType;
 
     PairSet(ParentType& _parent, NativeNaturalType _childIndex = 0) :Super(_parent, _childIndex) { }
@@ -61,6 +61,17 @@ struct PairSet : public MetaSet<FirstKeyType, _ParentType> {
         return innerSet.insertElement(element.second);
     }
 
+    template<typename BatchType>
+    NativeNaturalType insertElements(FirstKeyType firstKey, BatchType& secondKeys) {
+        NativeNaturalType firstAt;
+        if(secondKeys.isEmpty())
+            return 0;
+        if(!findFirstKey(firstKey, firstAt))
+            Super::insertElementAt(firstAt, firstKey);
+        ValueType innerSet = getValueAt(firstAt);
+        return innerSet.insertElements(secondKeys);
+    }
+
     bool eraseElement(ElementType element) {
         NativeNaturalType firstAt;
         if(!findFirstKey(element.first, firstAt))
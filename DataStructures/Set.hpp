@@ -28,6 +28,47 @@ struct SetTemplate : public _Super {
         Super::setKeyAt(newAt, key);
         return true;
     }
+
+    template<typename BatchType>
+    NativeNaturalType insertElements(BatchType& batch) {
+        NativeNaturalType elementCount = Super::getElementCount(), batchCount = batch.getElementCount(),
+                          insertedCount = 0, at = 0;
+        batch.sortElements();
+        auto lowerBound = [&](KeyType key, NativeNaturalType begin, NativeNaturalType end) {
+            return binarySearch<NativeNaturalType>(begin, end, [&](NativeNaturalType at) {
+                return Super::getKeyAt(at) < key;
+            });
+        };
+        for(NativeNaturalType batchAt = 0; batchAt < batchCount; ++batchAt) {
+            KeyType key = batch.getElementAt(batchAt).first;
+            if(batchAt > 0 && batch.getElementAt(batchAt-1).first == key)
+                continue;
+            at = lowerBound(key, at, elementCount);
+            if(at == elementCount || Super::getKeyAt(at) != key)
+                ++insertedCount;
+        }
+        if(insertedCount == 0)
+            return 0;
+        // Merges backwards in place, so every run of existing elements moves only once
+        Super::setElementCount(elementCount+insertedCount);
+        BitVector& bitVector = Super::getBitVector();
+        NativeNaturalType end = elementCount, insertAt = elementCount+insertedCount;
+        for(NativeNaturalType batchAt = batchCount; insertAt > end; --batchAt) {
+            ElementType element = batch.getElementAt(batchAt-1);
+            if(batchAt > 1 && batch.getElementAt(batchAt-2).first == element.first)
+                continue;
+            at = lowerBound(element.first, 0, end);
+            if(at < end && Super::getKeyAt(at) == element.first)
+                continue;
+            if(at < end) {
+                insertAt -= end-at;
+                bitVector.replaceSlice(bitVector, Super::getOffsetOfElement(insertAt), Super::getOffsetOfElement(at), (end-at)*sizeOfInBits<ElementType>::value);
+                end = at;
+            }
+            Super::setElementAt(--insertAt, element);
+        }
+        return insertedCount;
+    }
 };
 
 template<typename KeyType, typename ValueType = VoidType, typename _ParentType = BitVectorContainer>
@@ -9,7 +9,6 @@ struct Vector {
 
     Vector(ParentType& _parent, NativeNaturalType _childIndex = 0) :parent(_parent), childIndex(_childIndex) { }
     usingRemappedMethod(setElementCount)
-    usingRemappedMethod(swapElementsAt)
     usingRemappedMethod(iterateElements)
     usingRemappedMethod(iterate)
     usingRemappedMethod(getFirstElement)
@@ -50,6 +49,74 @@ struct Vector {
         return element;
     }
 
+    bool getElements(NativeNaturalType at, NativeNaturalType count, ElementType* elements) {
+        return getBitVector().template externalOperate<false>(elements, getOffsetOfElement(at), count*sizeOfInBits<ElementType>::value);
+    }
+
+    bool setElements(NativeNaturalType at, NativeNaturalType count, const ElementType* elements) {
+        return getBitVector().template externalOperate<true>(elements, getOffsetOfElement(at), count*sizeOfInBits<ElementType>::value);
+    }
+
+    bool fillElements(NativeNaturalType at, NativeNaturalType count, ElementType element) {
+        if(count == 0 || at+count > getElementCount())
+            return false;
+        setElementAt(at, element);
+        BitVector& bitVector = getBitVector();
+        NativeNaturalType offset = getOffsetOfElement(at), length = count*sizeOfInBits<ElementType>::value;
+        for(NativeNaturalType filled = sizeOfInBits<ElementType>::value; filled < length; filled *= 2)
+            bitVector.interoperation(bitVector, offset+filled, offset, min(filled, length-filled));
+        return true;
+    }
+
+    void sortElements() {
+        NativeNaturalType elementCount = getElementCount(), length = elementCount*sizeOfInBits<ElementType>::value;
+        if(elementCount < 2)
+            return;
+        BitVectorGuard<DataStructure<Vector<ElementType>>> buffers[2];
+        auto source = &buffers[0], destination = &buffers[1];
+        source->setElementCount(elementCount);
+        destination->setElementCount(elementCount);
+        source->getBitVector().interoperation(getBitVector(), 0, getOffsetOfElement(0), length);
+        for(NativeNaturalType shift = 0; shift < architectureSize; shift += 8) {
+            NativeNaturalType positions[256] = {};
+            source->iterateElements([&](ElementType element) {
+                ++positions[(static_cast<NativeNaturalType>(element)>>shift)&255];
+            });
+            if(positions[(static_cast<NativeNaturalType>(source->getElementAt(0))>>shift)&255] == elementCount)
+                continue;
+            for(NativeNaturalType digit = 0, position = 0; digit < 256; ++digit) {
+                NativeNaturalType count = positions[digit];
+                positions[digit] = position;
+                position += count;
+            }
+            source->iterateElements([&](ElementType element) {
+                destination->setElementAt(positions[(static_cast<NativeNaturalType>(element)>>shift)&255]++, element);
+            });
+            auto swap = source;
+            source = destination;
+            destination = swap;
+        }
+        getBitVector().interoperation(source->getBitVector(), getOffsetOfElement(0), 0, length);
+    }
+
+    void swapElementsAt(NativeNaturalType a, NativeNaturalType b) {
+        ElementType elementA, elementB;
+        NativeNaturalType offsetA = getOffsetOfElement(a), offsetB = getOffsetOfElement(b);
+        BitVectorOperation<false> reads[2];
+        BitVectorOperation<true> writes[2];
+        reads[offsetA > offsetB] = {&elementA, offsetA, sizeOfInBits<ElementType>::value};
+        reads[offsetA <= offsetB] = {&elementB, offsetB, sizeOfInBits<ElementType>::value};
+        writes[offsetA > offsetB] = {&elementB, offsetA, sizeOfInBits<ElementType>::value};
+        writes[offsetA <= offsetB] = {&elementA, offsetB, sizeOfInBits<ElementType>::value};
+        assert(getBitVector().externalOperateBatch(reads, 2));
+        assert(getBitVector().externalOperateBatch(writes, 2));
+    }
+
+    bool reserve(NativeNaturalType elementCount) {
+        BitVector& bitVector = getBitVector();
+        return bitVector.reserve(bitVector.getSize()-parent.getChildLength(childIndex)+elementCount*sizeOfInBits<ElementType>::value);
+    }
+
     void insertRange(NativeNaturalType at, NativeNaturalType elementCount) {
         parent.increaseSize(getOffsetOfElement(at), elementCount*sizeOfInBits<ElementType>::value, childIndex);
     }
@@ -70,13 +137,7 @@ struct Vector {
     bool moveElementAt(NativeNaturalType dstAt, NativeNaturalType srcAt) {
         if(dstAt == srcAt)
             return false;
-        bool upward = (dstAt > srcAt);
-        if(upward)
-            ++dstAt;
-        insertElementAt(dstAt, getElementAt(srcAt));
-        if(!upward)
-            ++srcAt;
-        eraseElementAt(srcAt);
+        getBitVector().moveSlice(getOffsetOfElement(dstAt), getOffsetOfElement(srcAt), sizeOfInBits<ElementType>::value);
         return true;
     }
 };
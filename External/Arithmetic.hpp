@@ -8,10 +8,8 @@ struct ArithmeticCodecStaticModel {
         :symbolCount(_symbolCount), totalFrequency(_symbolCount) {
         symbolFrequencies.setElementCount(symbolCount);
         cumulativeFrequencies.setElementCount(symbolCount);
-        for(NativeNaturalType symbolIndex = 0; symbolIndex < symbolCount; ++symbolIndex) {
-            symbolFrequencies.setElementAt(symbolIndex, 1);
-            cumulativeFrequencies.setElementAt(symbolIndex, symbolIndex+1);
-        }
+        assert(symbolFrequencies.fillElements(0, symbolCount, 1));
+        updateFrequency(0);
     }
 
     Natural32 lowerFrequency(NativeNaturalType symbolIndex) {
@@ -23,10 +21,17 @@ struct ArithmeticCodecStaticModel {
     }
 
     void updateFrequency(NativeNaturalType symbolIndex) {
+        Natural32 frequencies[architectureSize];
         totalFrequency = lowerFrequency(symbolIndex);
-        for(; symbolIndex < symbolCount; ++symbolIndex) {
-            totalFrequency += symbolFrequencies.getElementAt(symbolIndex);
-            cumulativeFrequencies.setElementAt(symbolIndex, totalFrequency);
+        while(symbolIndex < symbolCount) {
+            NativeNaturalType count = min(symbolCount-symbolIndex, static_cast<NativeNaturalType>(architectureSize));
+            symbolFrequencies.getElements(symbolIndex, count, frequencies);
+            for(NativeNaturalType index = 0; index < count; ++index) {
+                totalFrequency += frequencies[index];
+                frequencies[index] = totalFrequency;
+            }
+            cumulativeFrequencies.setElements(symbolIndex, count, frequencies);
+            symbolIndex += count;
         }
     }
 
@@ -161,11 +166,12 @@ struct ArithmeticEncoder : public ArithmeticCodec {
 };
 
 struct ArithmeticDecoder : public ArithmeticCodec {
+    BitVectorCursor cursor;
     Natural32 buffer;
     NativeNaturalType offsetCorrection;
 
     ArithmeticDecoder(BitVector& _bitVector, NativeNaturalType& _offset, NativeNaturalType _symbolCount)
-        :ArithmeticCodec(_bitVector, _offset, _symbolCount), buffer(0) {
+        :ArithmeticCodec(_bitVector, _offset, _symbolCount), cursor(_bitVector), buffer(0) {
         const NativeNaturalType maxLength = BitMask<NativeNaturalType>::ceilLog2(full)-1;
         for(offsetCorrection = 0; decodeBit() && offsetCorrection < maxLength; ++offsetCorrection);
         buffer <<= maxLength-offsetCorrection;
@@ -177,7 +183,8 @@ struct ArithmeticDecoder : public ArithmeticCodec {
             ++offset;
             return false;
         } else {
-            bitVector.externalOperate<false>(&buffer, offset++, 1);
+            cursor.seek(offset++);
+            cursor.read(&buffer, 1);
             return true;
         }
     }
@@ -221,9 +228,10 @@ void arithmeticEncodeBitVector(BitVector& dst, NativeNaturalType& dstOffset,
         NativeNaturalType bitsToSymbol = 4) {
     assert(srcLength%bitsToSymbol == 0);
     ArithmeticEncoder encoder(dst, dstOffset, 1<<bitsToSymbol);
-    for(NativeNaturalType offset = srcOffset; offset < srcOffset+srcLength; offset += bitsToSymbol) {
+    BitVectorCursor cursor(src, srcOffset);
+    while(cursor.offset < srcOffset+srcLength) {
         NativeNaturalType symbolIndex = 0;
-        src.externalOperate<false>(&symbolIndex, offset, bitsToSymbol);
+        cursor.read(&symbolIndex, bitsToSymbol);
         encoder.encodeSymbol(symbolIndex);
     }
     encoder.encodeTermination();
@@ -234,9 +242,10 @@ void arithmeticDecodeBitVector(BitVector& dst, NativeNaturalType dstOffset, Nati
         NativeNaturalType bitsToSymbol = 4) {
     assert(dstLength%bitsToSymbol == 0);
     ArithmeticDecoder decoder(src, srcOffset, 1<<bitsToSymbol);
-    for(NativeNaturalType offset = dstOffset; offset < dstOffset+dstLength; offset += bitsToSymbol) {
+    BitVectorCursor cursor(dst, dstOffset);
+    while(cursor.offset < dstOffset+dstLength) {
         NativeNaturalType symbolIndex = decoder.decodeSymbol();
-        dst.externalOperate<true>(&symbolIndex, offset, bitsToSymbol);
+        cursor.write(&symbolIndex, bitsToSymbol);
     }
     decoder.decodeTermination();
 }
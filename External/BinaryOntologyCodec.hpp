@@ -150,19 +150,21 @@ struct BinaryOntologyEncoder : public BinaryOntologyCodec {
 struct BinaryOntologyDecoder : public BinaryOntologyCodec {
     Ontology* dstOntology;
     StaticHuffmanDecoder symbolHuffmanDecoder;
+    BitVectorCursor cursor;
 
     BinaryOntologyDecoder(Ontology* _dstOntology, BitVector& srcBitVector)
-        :BinaryOntologyCodec(srcBitVector), dstOntology(_dstOntology), symbolHuffmanDecoder(srcBitVector, offset) {}
+        :BinaryOntologyCodec(srcBitVector), dstOntology(_dstOntology), symbolHuffmanDecoder(srcBitVector, offset), cursor(srcBitVector) {}
 
     NativeNaturalType decodeNatural() {
         NativeNaturalType value;
         switch(numberOption) {
             case NumberOptionRaw:
-                bitVector.externalOperate<false>(&value, offset, naturalLength);
+                cursor.seek(offset);
+                cursor.read(&value, naturalLength);
                 offset += naturalLength;
                 break;
             case NumberOptionBinaryVariableLength:
-                value = decodeBvlNatural(bitVector, offset);
+                value = decodeBvlNatural(cursor, offset);
                 break;
             default:
                 assert(false);
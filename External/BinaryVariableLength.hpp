@@ -9,32 +9,40 @@ void encodeBvlNatural(BitVector& bitVector, NativeNaturalType& dstOffset, Native
     dstLength += 1<<dstLength;
     bitVector.increaseSize(dstOffset, dstLength);
     --src;
+    BitVectorCursor cursor(bitVector, dstOffset);
     NativeNaturalType endOffset = dstOffset+dstLength-1;
-    while(dstOffset < endOffset) {
-        bitVector.externalOperate<true>(&flagBit, dstOffset++, 1);
-        bitVector.externalOperate<true>(&src, dstOffset, sliceLength);
+    while(cursor.offset < endOffset) {
+        cursor.write(&flagBit, 1);
+        cursor.write(&src, sliceLength);
         src >>= sliceLength;
-        dstOffset += sliceLength;
         sliceLength <<= 1;
     }
     flagBit = 0;
-    bitVector.externalOperate<true>(&flagBit, dstOffset++, 1);
+    cursor.write(&flagBit, 1);
+    dstOffset = cursor.offset;
 }
 
-NativeNaturalType decodeBvlNatural(BitVector& bitVector, NativeNaturalType& srcOffset) {
-    assert(srcOffset < bitVector.getSize());
+NativeNaturalType decodeBvlNatural(BitVectorCursor& cursor, NativeNaturalType& srcOffset) {
+    assert(srcOffset < cursor.bitVector.getSize());
     NativeNaturalType dstOffset = 0, sliceLength = 1, dst = 0;
+    cursor.seek(srcOffset);
     while(true) {
         Natural8 flagBit = 0;
-        bitVector.externalOperate<false>(&flagBit, srcOffset++, 1);
-        if(!flagBit)
+        cursor.read(&flagBit, 1);
+        if(!flagBit) {
+            srcOffset = cursor.offset;
             return (dstOffset == 0) ? dst : dst+1;
+        }
         NativeNaturalType buffer = 0;
-        bitVector.externalOperate<false>(&buffer, srcOffset, sliceLength);
+        cursor.read(&buffer, sliceLength);
         dst |= buffer<<dstOffset;
-        srcOffset += sliceLength;
         dstOffset += sliceLength;
         sliceLength <<= 1;
         assert(dstOffset < architectureSize);
     }
 }
+
+NativeNaturalType decodeBvlNatural(BitVector& bitVector, NativeNaturalType& srcOffset) {
+    BitVectorCursor cursor(bitVector);
+    return decodeBvlNatural(cursor, srcOffset);
+}
@@ -41,14 +41,16 @@ struct ChaCha20 {
 
     void applyOnBitVector(BitVector& bitVector) {
         ChaCha20 buffer, mask;
+        BitVectorCursor cursor(bitVector);
         NativeNaturalType endOffset = bitVector.getSize(), offset = 0;
         while(offset < endOffset) {
             NativeNaturalType sliceLength = min(endOffset-offset, sizeOfInBits<ChaCha20>::value);
             mask.generate(*this);
-            bitVector.externalOperate<false>(&buffer, offset, sliceLength);
+            cursor.read(&buffer, sliceLength);
             for(Natural8 i = 0; i < 8; ++i)
                 buffer.block64[i] ^= mask.block64[i];
-            bitVector.externalOperate<true>(&buffer, offset, sliceLength);
+            cursor.seek(offset);
+            cursor.write(&buffer, sliceLength);
             offset += sliceLength;
         }
     }
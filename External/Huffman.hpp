@@ -10,14 +10,34 @@ struct StaticHuffmanCodec {
 
 struct StaticHuffmanEncoder : public StaticHuffmanCodec {
     BitVectorGuard<DataStructure<Set<Symbol, NativeNaturalType>>> symbolMap;
+    BitVectorGuard<DataStructure<Vector<Symbol>>> countedSymbols;
     BitVectorGuard<BitVector> huffmanCodes;
+    static constexpr NativeNaturalType countedSymbolsCapacity = 4096;
 
+    // Merging moves the whole symbolMap, so it waits until at least as many symbols were counted
     void countSymbol(Symbol symbol) {
-        NativeNaturalType index;
-        if(symbolMap.findKey(symbol, index))
-            symbolMap.setValueAt(index, symbolMap.getValueAt(index)+1);
-        else
-            symbolMap.insertElement(Pair<Symbol, NativeNaturalType>{symbol, 1});
+        countedSymbols.insertAsLastElement(symbol);
+        if(countedSymbols.getElementCount() >= max(countedSymbolsCapacity, symbolMap.getElementCount()))
+            mergeCountedSymbols();
+    }
+
+    void mergeCountedSymbols() {
+        BitVectorGuard<DataStructure<Vector<Pair<Symbol, NativeNaturalType>>>> batch;
+        countedSymbols.sortElements();
+        countedSymbols.iterateElements([&](Symbol symbol) {
+            NativeNaturalType last = batch.getElementCount()-1;
+            if(batch.isEmpty() || batch.getElementAt(last).first != symbol)
+                batch.insertAsLastElement(Pair<Symbol, NativeNaturalType>{symbol, 1});
+            else
+                batch.setElementAt(last, {symbol, batch.getElementAt(last).second+1});
+        });
+        countedSymbols.setElementCount(0);
+        batch.iterateElements([&](Pair<Symbol, NativeNaturalType> pair) {
+            NativeNaturalType index;
+            if(symbolMap.findKey(pair.first, index))
+                symbolMap.setValueAt(index, symbolMap.getValueAt(index)+pair.second);
+        });
+        symbolMap.insertElements(batch);
     }
 
     void encodeSymbol(Symbol symbol) {
@@ -33,6 +53,7 @@ struct StaticHuffmanEncoder : public StaticHuffmanCodec {
     }
 
     void encodeTree() {
+        mergeCountedSymbols();
         symbolCount = symbolMap.getElementCount();
         encodeBvlNatural(bitVector, offset, symbolCount);
         if(symbolCount < 2) {
@@ -45,11 +66,15 @@ struct StaticHuffmanEncoder : public StaticHuffmanCodec {
                           huffmanChildrenCount = symbolCount-1,
                           huffmanParentsCount = huffmanChildrenCount*2;
         BitVectorGuard<DataStructure<Heap<Ascending, NativeNaturalType, Symbol>>> symbolHeap;
+        Pair<NativeNaturalType, Symbol> heapElements[256];
         symbolHeap.setElementCount(symbolCount);
         symbolMap.iterateElements([&](Pair<Symbol, NativeNaturalType> pair) {
-            symbolHeap.setElementAt(index, {pair.second, index});
-            ++index;
+            heapElements[index%256] = {pair.second, index};
+            if(++index%256 == 0)
+                assert(symbolHeap.setElements(index-256, 256, heapElements));
         });
+        if(index%256)
+            assert(symbolHeap.setElements(index-index%256, index%256, heapElements));
         symbolHeap.build();
 
         struct HuffmanParentNode {
@@ -127,6 +152,7 @@ struct StaticHuffmanEncoder : public StaticHuffmanCodec {
 };
 
 struct StaticHuffmanDecoder : public StaticHuffmanCodec {
+    BitVectorCursor cursor;
     BitVectorGuard<DataStructure<Vector<Symbol>>> symbolVector;
     BitVectorGuard<DataStructure<Vector<NativeNaturalType>>> huffmanChildren;
 
@@ -141,7 +167,8 @@ struct StaticHuffmanDecoder : public StaticHuffmanCodec {
                 if(bitsLeft == 0) {
                     bitsLeft = min(static_cast<NativeNaturalType>(architectureSize), bitVector.getSize()-offset);
                     assert(bitsLeft);
-                    bitVector.externalOperate<false>(&mask, offset, bitsLeft);
+                    cursor.seek(offset);
+                    cursor.read(&mask, bitsLeft);
                     offset += bitsLeft;
                 }
                 index = huffmanChildren.getElementAt(index*2+(mask&1));
@@ -157,18 +184,18 @@ struct StaticHuffmanDecoder : public StaticHuffmanCodec {
     }
 
     void decodeTree() {
-        symbolCount = decodeBvlNatural(bitVector, offset);
+        symbolCount = decodeBvlNatural(cursor, offset);
         symbolVector.setElementCount(symbolCount);
         if(symbolCount < 2) {
             if(symbolCount == 1)
-                symbolVector.setElementAt(0, decodeBvlNatural(bitVector, offset));
+                symbolVector.setElementAt(0, decodeBvlNatural(cursor, offset));
             return;
         }
         huffmanChildren.setElementCount((symbolCount-1)*2);
         BitVectorGuard<DataStructure<Vector<NativeNaturalType>>> stack;
         NativeNaturalType symbolIndex = 0, huffmanChildrenIndex = 0;
         while(huffmanChildrenIndex < symbolCount-1) {
-            Symbol symbol = decodeBvlNatural(bitVector, offset);
+            Symbol symbol = decodeBvlNatural(cursor, offset);
             if(symbol > 0) {
                 --symbol;
                 symbolVector.setElementAt(symbolIndex, symbol);
@@ -184,5 +211,5 @@ struct StaticHuffmanDecoder : public StaticHuffmanCodec {
         }
     }
 
-    StaticHuffmanDecoder(BitVector& _bitVector, NativeNaturalType& _offset) :StaticHuffmanCodec(_bitVector, _offset) {}
+    StaticHuffmanDecoder(BitVector& _bitVector, NativeNaturalType& _offset) :StaticHuffmanCodec(_bitVector, _offset), cursor(_bitVector) {}
 };
@@ -216,10 +216,12 @@ struct Ontology : public SymbolSpace {
         if(alpha.isEmpty())
             return 0;
         BitVectorGuard<DataStructure<Set<Symbol>>> result;
+        BitVectorGuard<DataStructure<Vector<Set<Symbol>::ElementType>>> batch;
         auto beta = alpha.getSubIndex(subIndex);
         beta.iterateElements([&](Pair<Symbol, Symbol> betaResult) {
-            result.insertElement(betaResult.second);
+            batch.insertAsLastElement(betaResult.second);
         });
+        result.insertElements(batch);
         if(callback)
             result.iterateElements([&](Symbol gamma) {
                 triple.pos[2] = gamma;
@@ -419,16 +421,18 @@ struct Ontology : public SymbolSpace {
         if(alpha.isEmpty())
             return false;
         BitVectorGuard<DataStructure<Set<Symbol>>> dirty;
+        BitVectorGuard<DataStructure<Vector<Set<Symbol>::ElementType>>> batch;
         forEachSubIndex() {
             auto beta = alpha.getSubIndex(subIndex);
             beta.iterateFirstKeys([&](Symbol betaResult) {
-                dirty.insertElement(betaResult);
+                batch.insertAsLastElement(betaResult);
             });
             beta.iterateElements([&](Pair<Symbol, Symbol> betaResult) {
-                dirty.insertElement(betaResult.second);
+                batch.insertAsLastElement(betaResult.second);
                 unlinkWithoutReleasing(Triple(symbol, betaResult.first, betaResult.second).normalized(subIndex), true, symbol);
             });
         }
+        dirty.insertElements(batch);
         releaseSymbol(symbol);
         dirty.iterateElements([&](Symbol symbol) {
             tryToReleaseSymbol(symbol);
@@ -4,6 +4,37 @@ const NativeNaturalType bitsPerPage = 1<<15, minPageCount = 1;
 
 struct BasePage {
     NativeNaturalType transaction;
+
+    // Waits for the writer holding the page, so a thread must never read a page it has locked itself
+    NativeNaturalType readVersion() const {
+        while(true) {
+            NativeNaturalType version = __atomic_load_n(&transaction, __ATOMIC_ACQUIRE);
+            if(!(version&1))
+                return version;
+#if defined(__x86_64__) || defined(__i386__)
+            __builtin_ia32_pause();
+#endif
+        }
+    }
+    bool validateVersion(NativeNaturalType version) const {
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        return __atomic_load_n(&transaction, __ATOMIC_RELAXED) == version;
+    }
+
+    bool isLocked() const {
+        return transaction&1;
+    }
+
+    void lock() {
+        assert(!isLocked());
+        __atomic_store_n(&transaction, transaction+1, __ATOMIC_RELAXED);
+        __atomic_thread_fence(__ATOMIC_RELEASE);
+    }
+
+    void unlock() {
+        assert(isLocked());
+        __atomic_store_n(&transaction, transaction+1, __ATOMIC_RELEASE);
+    }
 };
 
 struct Stats {
@@ -15,10 +46,21 @@ struct Stats {
                       inhabitedPayload;
 };
 
+enum StatsCategory {
+    MetaStructsStats,
+    BitVectorIndexStats,
+    FullBucketsStats,
+    FreeBucketsStats,
+    FragmentedStats,
+    StatsCategoryCount
+};
+
 void resizeMemory(NativeNaturalType pagesEnd);
 
 template<typename PageType>
 PageType* dereferencePage(PageRefType pageRef);
 PageRefType referenceOfPage(void* page);
 PageRefType acquirePage();
+PageRefType getPagesEnd();
 void releasePage(PageRefType pageRef);
+Stats& getStats(NativeNaturalType category);
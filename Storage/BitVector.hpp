@@ -7,54 +7,79 @@ struct BitVectorLocation {
     BitVectorLocation(SymbolSpace* _symbolSpace, Symbol _symbol) :symbolSpace(_symbolSpace), symbol(_symbol) {}
 
     bool operator==(const BitVectorLocation& other) const {
-        return symbolSpace->spaceSymbol == other.symbolSpace->spaceSymbol && symbol == other.symbol;
+        return symbol == other.symbol && symbolSpace && other.symbolSpace && symbolSpace->spaceSymbol == other.symbolSpace->spaceSymbol;
     }
 
     bool getAddress(NativeNaturalType& address) {
-        BpTreeMap<Symbol, NativeNaturalType>::Iterator<true> iter;
-        if(!symbolSpace->state.bitVectors.find<Key>(iter, symbol))
-            return false;
-        address = iter.getValue();
-        return true;
+        if(symbolSpace->readAddressCache(symbol, address)) {
+            __atomic_fetch_add(&addressCacheHits, 1, __ATOMIC_RELAXED);
+            return address != 0;
+        }
+        __atomic_fetch_add(&addressCacheMisses, 1, __ATOMIC_RELAXED);
+        NativeNaturalType epoch = symbolSpace->getAddressCacheEpoch();
+        if(!symbolSpace->state.bitVectors.findValue(symbol, address))
+            address = 0;
+        symbolSpace->fillAddressCache(symbol, address, epoch);
+        return address != 0;
     }
 
     void setAddress(NativeNaturalType address) {
-        BpTreeMap<Symbol, NativeNaturalType>::Iterator<true> iter;
+        SymbolSpaceState::BitVectorIndex::Iterator<true> iter;
         symbolSpace->state.bitVectors.find<Key>(iter, symbol);
         iter.setValue(address);
+        symbolSpace->updateAddressCache(symbol, address);
     }
 
     void insertAddress(NativeNaturalType address) {
         symbolSpace->state.bitVectors.insert(symbol, address);
         ++symbolSpace->state.bitVectorCount;
         symbolSpace->updateState();
+        symbolSpace->updateAddressCache(symbol, address);
     }
 
     void eraseAddress() {
         symbolSpace->state.bitVectors.erase<Key>(symbol);
         --symbolSpace->state.bitVectorCount;
         symbolSpace->updateState();
+        symbolSpace->updateAddressCache(symbol, 0);
     }
 };
 
+template<bool overwrite>
+struct BitVectorOperation {
+    typename conditional<overwrite, const void*, void*>::type data;
+    NativeNaturalType offset, length;
+};
+
 struct BitVector {
     BitVectorLocation location;
     PageRefType pageRef;
-    NativeNaturalType address, offsetInPage, indexInBucket;
+    NativeNaturalType address, offsetInPage, indexInBucket, reservedCapacity;
     Natural16 bucketType;
     BpTreeBitVector bpTree;
     BitVectorBucket* bucket;
+    const NativeNaturalType* mappedData;
+    NativeNaturalType mappedSize;
     enum State {
         Empty,
+        Inline,
         InBucket,
-        Fragmented
+        Fragmented,
+        Mapped
     } state;
 
-    BitVector(BitVectorLocation _location) :location(_location) {
+    static constexpr NativeNaturalType inlineBits = architectureSize-8,
+                                       inlineFlag = static_cast<NativeNaturalType>(1)<<(architectureSize-1);
+
+    BitVector(BitVectorLocation _location) :location(_location), reservedCapacity(0) {
         if(!location.getAddress(address)) {
             state = Empty;
             return;
         }
+        if(address&inlineFlag) {
+            state = Inline;
+            return;
+        }
         pageRef = address/bitsPerPage;
         offsetInPage = address-pageRef*bitsPerPage;
         if(offsetInPage > 0) {
@@ -67,10 +92,60 @@ struct BitVector {
         }
     }
 
+    // Read-only view of external memory, which has to stay mapped while in use
+    BitVector(const void* data, NativeNaturalType size) :location(nullptr, 0), address(0), reservedCapacity(0),
+        mappedData(reinterpret_cast<const NativeNaturalType*>(data)), mappedSize(size), state(Mapped) {}
+
     BitVector& getBitVector() {
         return *this;
     }
 
+    NativeNaturalType getInlineData() const {
+        return address&BitMask<NativeNaturalType>::fillLSBs(inlineBits);
+    }
+
+    // Inline data is a copy of the index entry, another BitVector of the same location may have written it since.
+    // Resizing through one BitVector still requires the others to be recreated.
+    void reloadInline() {
+        if(state != Inline)
+            return;
+        NativeNaturalType size = getSize();
+        location.getAddress(address);
+        assert((address&inlineFlag) && getSize() == size);
+    }
+
+    void setInline(NativeNaturalType size, NativeNaturalType data) {
+        assert(size > 0 && size <= inlineBits);
+        state = Inline;
+        address = inlineFlag|(size<<inlineBits)|data;
+    }
+
+    bool adoptNeighboringBucket(NativeNaturalType neighborAddress) {
+        PageRefType neighborPageRef = neighborAddress/bitsPerPage;
+        if((neighborAddress&inlineFlag) || neighborAddress == neighborPageRef*bitsPerPage)
+            return false;
+        auto neighborBucket = dereferencePage<BitVectorBucket>(neighborPageRef);
+        if(neighborBucket->header.type != bucketType || neighborBucket->isFull())
+            return false;
+        pageRef = neighborPageRef;
+        bucket = neighborBucket;
+        return true;
+    }
+
+    bool findNeighboringBucket() {
+        auto& bitVectors = location.symbolSpace->state.bitVectors;
+        if(bitVectors.isEmpty())
+            return false;
+        SymbolSpaceState::BitVectorIndex::Iterator<true> lower, higher;
+        bool found = bitVectors.find<Key>(higher, location.symbol);
+        lower.copy(higher);
+        if(lower.advance<-1>() == 0 && adoptNeighboringBucket(lower.getValue()))
+            return true;
+        if(found)
+            return higher.advance<1>() == 0 && adoptNeighboringBucket(higher.getValue());
+        return higher[0]->index < higher[0]->endIndex && adoptNeighboringBucket(higher.getValue());
+    }
+
     void allocateInBucket(NativeNaturalType size) {
         assert(size > 0);
         if(superPage->freeBitVectorBuckets[bucketType].isEmpty()) {
@@ -78,7 +153,7 @@ struct BitVector {
             bucket = dereferencePage<BitVectorBucket>(pageRef);
             bucket->init(bucketType);
             assert(superPage->freeBitVectorBuckets[bucketType].insert(pageRef));
-        } else {
+        } else if(!findNeighboringBucket()) {
             pageRef = superPage->freeBitVectorBuckets[bucketType].template getOne<First, false>();
             bucket = dereferencePage<BitVectorBucket>(pageRef);
         }
@@ -93,15 +168,12 @@ struct BitVector {
     }
 
     template<NativeIntegerType dir>
-    static NativeIntegerType segmentInteroperation(NativeNaturalType dst, NativeNaturalType src, NativeNaturalType length) {
+    static NativeIntegerType segmentInteroperation(NativeNaturalType* dstBase, NativeNaturalType dst,
+                                                   const NativeNaturalType* srcBase, NativeNaturalType src, NativeNaturalType length) {
         if(dir == 0)
-            return bitwiseCompare(reinterpret_cast<NativeNaturalType*>(superPage),
-                                  reinterpret_cast<const NativeNaturalType*>(superPage),
-                                  dst, src, length);
+            return bitwiseCompare(dstBase, srcBase, dst, src, length);
         else {
-            bitwiseCopy<dir>(reinterpret_cast<NativeNaturalType*>(superPage),
-                             reinterpret_cast<const NativeNaturalType*>(superPage),
-                             dst, src, length);
+            bitwiseCopy<dir>(dstBase, srcBase, dst, src, length);
             return 0;
         }
     }
@@ -118,12 +190,30 @@ struct BitVector {
             } else
                 return offset;
         } else
-            return (state == Fragmented) ? iter[0]->endIndex-iter[0]->index : bucket->getSize(indexInBucket)-offset;
+            return (state == Fragmented) ? iter[0]->endIndex-iter[0]->index : getSize()-offset;
+    }
+
+    NativeNaturalType* baseOfInteroperation() {
+        switch(state) {
+            case Inline:
+                return &address;
+            case Mapped:
+                return const_cast<NativeNaturalType*>(mappedData);
+            default:
+                return reinterpret_cast<NativeNaturalType*>(superPage);
+        }
     }
 
     template<typename IteratorType>
     NativeNaturalType addressOfInteroperation(IteratorType& iter, NativeNaturalType offset) {
-        return (state == Fragmented) ? iter[0]->pageRef*bitsPerPage+BpTreeBitVector::Page::valueOffset+iter[0]->index : address+offset;
+        switch(state) {
+            case Inline:
+                return offset;
+            case Fragmented:
+                return iter[0]->pageRef*bitsPerPage+BpTreeBitVector::Page::valueOffset+iter[0]->index;
+            default:
+                return address+offset;
+        }
     }
 
     template<NativeIntegerType dir, typename IteratorType>
@@ -143,10 +233,14 @@ struct BitVector {
 
     template<NativeIntegerType dir = -1>
     NativeIntegerType interoperation(BitVector src, NativeNaturalType dstOffset, NativeNaturalType srcOffset, NativeNaturalType length) {
+        reloadInline();
+        src.reloadInline();
         NativeNaturalType dstEndOffset = dstOffset+length, srcEndOffset = srcOffset+length;
         if(dstOffset >= dstEndOffset || dstEndOffset > getSize() ||
            srcOffset >= srcEndOffset || srcEndOffset > src.getSize())
             return 0;
+        if(dir != 0)
+            unshare();
         NativeNaturalType segment[2], intersection, result;
         BpTreeBitVector::Iterator<dir != 0> iter[2];
         if(dir == 1) {
@@ -165,9 +259,14 @@ struct BitVector {
                 advanceBySegmentSize<1>(iter[0], dstOffset, intersection);
                 src.advanceBySegmentSize<1>(iter[1], srcOffset, intersection);
             }
-            result = segmentInteroperation<dir>(addressOfInteroperation(iter[0], dstOffset),
-                                                src.addressOfInteroperation(iter[1], srcOffset),
+            BpTreeBitVector::Page* page = (dir != 0 && state == Fragmented) ? BpTreeBitVector::getPage(iter[0][0]->pageRef) : nullptr;
+            if(page)
+                page->header.lock();
+            result = segmentInteroperation<dir>(baseOfInteroperation(), addressOfInteroperation(iter[0], dstOffset),
+                                                src.baseOfInteroperation(), src.addressOfInteroperation(iter[1], srcOffset),
                                                 intersection);
+            if(page)
+                page->header.unlock();
             length -= intersection;
             if(length == 0 || result != 0)
                 break;
@@ -176,6 +275,8 @@ struct BitVector {
                 src.advanceBySegmentSize<-1>(iter[1], srcOffset, intersection);
             }
         }
+        if(dir != 0 && state == Inline)
+            location.setAddress(address);
         return (dir == 0) ? result : 1;
     }
 
@@ -185,27 +286,122 @@ struct BitVector {
         typedef typename conditional<overwrite, NativeNaturalType*, const NativeNaturalType*>::type CopyType1;
         if(length == 0 || offset+length > getSize())
             return false;
-        if(state == InBucket) {
-            bitwiseCopySwap<overwrite>(reinterpret_cast<CopyType0>(data), reinterpret_cast<CopyType1>(superPage),
+        if(overwrite)
+            unshare();
+        reloadInline();
+        if(state == Inline) {
+            bitwiseCopySwap<overwrite>(reinterpret_cast<CopyType0>(data), reinterpret_cast<CopyType1>(&address),
+                                       0, offset, length);
+            if(overwrite)
+                location.setAddress(address);
+        } else if(state != Fragmented) {
+            bitwiseCopySwap<overwrite>(reinterpret_cast<CopyType0>(data), reinterpret_cast<CopyType1>(baseOfInteroperation()),
                                        0, address+offset, length);
         } else {
             BpTreeBitVector::Iterator<false> iter;
-            bpTree.find<Rank>(iter, offset);
+            NativeNaturalType rank = offset;
+            bpTree.find<Rank>(iter, rank);
             offset = 0;
             while(true) {
                 NativeNaturalType segment = min(length, static_cast<NativeNaturalType>(iter[0]->endIndex-iter[0]->index));
+                BpTreeBitVector::Page* page = BpTreeBitVector::getPage(iter[0]->pageRef);
+                if(overwrite)
+                    page->header.lock();
                 bitwiseCopySwap<overwrite>(reinterpret_cast<CopyType0>(data), reinterpret_cast<CopyType1>(superPage),
                                            offset, addressOfInteroperation(iter, 0), segment);
+                if(overwrite)
+                    page->header.unlock();
+                else if(!iter.validate()) {
+                    // Seeking would keep the outdated versions of the frames it does not descend through again
+                    bpTree.find<Rank>(iter, rank+offset);
+                    continue;
+                }
                 length -= segment;
                 if(length == 0)
                     break;
-                iter.template advance<1>(0, segment);
                 offset += segment;
+                if(iter.template advance<1>(0, segment) != 0)
+                    bpTree.seek<Rank>(iter, rank+offset);
             }
         }
         return true;
     }
 
+    // Consecutive operations inside the same leaf share one lookup, so callers have to order them by offset.
+    // Unordered batches stay correct but may look up a leaf once per operation.
+    template<bool overwrite>
+    bool externalOperateBatch(const BitVectorOperation<overwrite>* operations, NativeNaturalType count) {
+        typedef typename conditional<overwrite, const NativeNaturalType*, NativeNaturalType*>::type CopyType0;
+        typedef typename conditional<overwrite, NativeNaturalType*, const NativeNaturalType*>::type CopyType1;
+        NativeNaturalType size = getSize();
+        for(NativeNaturalType i = 0; i < count; ++i)
+            if(operations[i].length == 0 || operations[i].offset+operations[i].length > size)
+                return false;
+        if(overwrite)
+            unshare();
+        if(state != Fragmented) {
+            for(NativeNaturalType i = 0; i < count; ++i)
+                externalOperate<overwrite>(operations[i].data, operations[i].offset, operations[i].length);
+            return true;
+        }
+        BpTreeBitVector::Iterator<false> iter;
+        NativeNaturalType segmentBegin = 0, segmentEnd = 0;
+        for(NativeNaturalType i = 0; i < count; ++i) {
+            NativeNaturalType offset = operations[i].offset, length = operations[i].length;
+            if(offset < segmentBegin || offset+length > segmentEnd) {
+                NativeNaturalType rank = offset;
+                bpTree.find<Rank>(iter, rank);
+                segmentBegin = offset-iter[0]->index;
+                segmentEnd = segmentBegin+iter[0]->endIndex;
+                if(offset+length > segmentEnd) {
+                    externalOperate<overwrite>(operations[i].data, offset, length);
+                    segmentEnd = segmentBegin;
+                    continue;
+                }
+            }
+            BpTreeBitVector::Page* page = BpTreeBitVector::getPage(iter[0]->pageRef);
+            if(overwrite)
+                page->header.lock();
+            bitwiseCopySwap<overwrite>(reinterpret_cast<CopyType0>(operations[i].data), reinterpret_cast<CopyType1>(superPage), 0,
+                                       iter[0]->pageRef*bitsPerPage+BpTreeBitVector::Page::valueOffset+offset-segmentBegin, length);
+            if(overwrite) {
+                page->header.unlock();
+                iter[0]->version = page->header.readVersion();
+            } else if(!iter.validate()) {
+                externalOperate<overwrite>(operations[i].data, offset, length);
+                segmentEnd = segmentBegin;
+            }
+        }
+        return true;
+    }
+
+    // Spans stay valid until the next mutation of this BitVector
+    bool iterateSpans(NativeNaturalType offset, NativeNaturalType length,
+                      Closure<void(const NativeNaturalType*, NativeNaturalType, NativeNaturalType)> callback) {
+        if(length == 0 || offset+length > getSize())
+            return false;
+        if(state != Fragmented) {
+            reloadInline();
+            callback(baseOfInteroperation(), (state == Inline) ? offset : address+offset, length);
+            return true;
+        }
+        BpTreeBitVector::Iterator<false> iter;
+        NativeNaturalType rank = offset;
+        bpTree.find<Rank>(iter, rank);
+        offset = 0;
+        while(true) {
+            NativeNaturalType segment = min(length, static_cast<NativeNaturalType>(iter[0]->endIndex-iter[0]->index));
+            callback(baseOfInteroperation(), addressOfInteroperation(iter, 0), segment);
+            length -= segment;
+            if(length == 0)
+                break;
+            offset += segment;
+            if(iter.template advance<1>(0, segment) != 0)
+                bpTree.seek<Rank>(iter, rank+offset);
+        }
+        return true;
+    }
+
     NativeIntegerType compare(BitVector other) {
         if(location == other.location)
             return 0;
@@ -221,14 +417,63 @@ struct BitVector {
         switch(state) {
             case Empty:
                 return 0;
+            case Inline:
+                return (address&~inlineFlag)>>inlineBits;
             case InBucket:
                 return bucket->getSize(indexInBucket);
             case Fragmented:
                 return bpTree.getElementCount();
+            case Mapped:
+                return mappedSize;
         }
         assert(false);
     }
 
+    NativeNaturalType getCapacity() {
+        switch(state) {
+            case Empty:
+                return reservedCapacity;
+            case Inline:
+                return inlineBits;
+            case InBucket:
+                return bucket->getMaxDataBits();
+            case Fragmented:
+            case Mapped:
+                return getSize();
+        }
+        assert(false);
+        return 0;
+    }
+
+    bool isInPlaceOf(const BitVector& other) const {
+        return state == InBucket && other.state == InBucket && pageRef == other.pageRef && indexInBucket == other.indexInBucket;
+    }
+
+    bool releaseShare() {
+        if(state != Fragmented || superPage->sharedBitVectors.isEmpty())
+            return false;
+        BpTreeMap<PageRefType, NativeNaturalType>::Iterator<true> iter;
+        if(!superPage->sharedBitVectors.find<Key>(iter, bpTree.rootPageRef))
+            return false;
+        NativeNaturalType shareCount = iter.getValue();
+        if(shareCount > 1)
+            iter.setValue(shareCount-1);
+        else
+            superPage->sharedBitVectors.erase<Key>(bpTree.rootPageRef);
+        return true;
+    }
+
+    void unshare() {
+        assert(state != Mapped);
+        if(!releaseShare())
+            return;
+        BpTreeBitVector shared = bpTree;
+        bpTree.init();
+        shared.copy(bpTree);
+        address = bpTree.rootPageRef*bitsPerPage;
+        location.setAddress(address);
+    }
+
     void setSize(NativeNaturalType newSize) {
         NativeNaturalType oldSize = getSize();
         if(oldSize < newSize)
@@ -237,39 +482,69 @@ struct BitVector {
             decreaseSize(newSize, oldSize-newSize);
     }
 
+    bool reserve(NativeNaturalType capacity) {
+        if(state == Fragmented || capacity <= getCapacity())
+            return true;
+        if(!BitVectorBucket::isBucketAllocatable(capacity))
+            return false;
+        if(state == Empty) {
+            // There is no slot without content, so the first increaseSize of this BitVector allocates it
+            reservedCapacity = capacity;
+            return true;
+        }
+        BitVector srcBitVector = *this;
+        NativeNaturalType size = getSize();
+        state = InBucket;
+        bucketType = BitVectorBucket::getType(capacity);
+        allocateInBucket(size);
+        interoperation(srcBitVector, 0, 0, size);
+        location.setAddress(address);
+        if(srcBitVector.state == InBucket)
+            srcBitVector.freeFromBucket();
+        return true;
+    }
+
     bool decreaseSize(NativeNaturalType offset, NativeNaturalType length) {
         NativeNaturalType size = getSize(), end = offset+length;
         if(offset >= end || end > size)
             return false;
         size -= length;
+        reloadInline();
         BitVector srcBitVector = *this;
         if(size == 0) {
             state = Empty;
             location.eraseAddress();
-        } else if(BitVectorBucket::isBucketAllocatable(size)) {
-            bucketType = BitVectorBucket::getType(size);
-            srcBitVector.bucketType = BitVectorBucket::getType(size+length);
-            if(srcBitVector.state == Fragmented || bucketType != srcBitVector.bucketType) {
-                state = InBucket;
-                allocateInBucket(size);
+        } else if(size <= inlineBits) {
+            NativeNaturalType data = (srcBitVector.state == Inline) ? getInlineData() : 0;
+            setInline(size, (data&BitMask<NativeNaturalType>::fillLSBs(offset))|((data>>end)<<offset));
+            location.setAddress(address);
+            if(srcBitVector.state != Inline) {
                 interoperation(srcBitVector, 0, 0, offset);
                 interoperation(srcBitVector, offset, end, size-offset);
-                location.setAddress(address);
-            } else {
-                interoperation<-1>(*this, offset, end, size-offset);
-                bucket->setSize(indexInBucket, size);
             }
-        } else {
+        } else if(srcBitVector.state == InBucket && !BitVectorBucket::isShrinkable(bucket->header.type, size)) {
+            interoperation<-1>(*this, offset, end, size-offset);
+            bucket->setSize(indexInBucket, size);
+        } else if(srcBitVector.state == Fragmented && !BitVectorBucket::isShrinkable(bitVectorBucketTypeCount, size)) {
+            unshare();
             BpTreeBitVector::Iterator<true> from, to;
             bpTree.find<Rank>(from, offset);
-            bpTree.find<Rank>(to, offset+length-1);
+            to.copy(from);
+            bpTree.seek<Rank>(to, offset+length-1);
             bpTree.erase(from, to);
             address = bpTree.rootPageRef*bitsPerPage;
             location.setAddress(address);
+        } else {
+            state = InBucket;
+            bucketType = BitVectorBucket::getType(size);
+            allocateInBucket(size);
+            interoperation(srcBitVector, 0, 0, offset);
+            interoperation(srcBitVector, offset, end, size-offset);
+            location.setAddress(address);
         }
-        if(srcBitVector.state == InBucket && !(state == InBucket && bucketType == srcBitVector.bucketType))
+        if(srcBitVector.state == InBucket && !isInPlaceOf(srcBitVector))
             srcBitVector.freeFromBucket();
-        if(srcBitVector.state == Fragmented && state != Fragmented)
+        if(srcBitVector.state == Fragmented && state != Fragmented && !srcBitVector.releaseShare())
             bpTree.erase();
         assert(size == getSize());
         return true;
@@ -279,22 +554,24 @@ struct BitVector {
         NativeNaturalType size = getSize();
         if(size >= size+length || offset > size)
             return false;
+        reloadInline();
         BitVector srcBitVector = *this;
         size += length;
-        if(BitVectorBucket::isBucketAllocatable(size)) {
+        if(srcBitVector.state == InBucket && size <= bucket->getMaxDataBits()) {
+            bucket->setSize(indexInBucket, size);
+            interoperation<1>(*this, offset+length, offset, size-length-offset);
+        } else if(size <= inlineBits && reservedCapacity <= inlineBits && srcBitVector.state != InBucket) {
+            NativeNaturalType data = (state == Inline) ? getInlineData() : 0;
+            setInline(size, (data&BitMask<NativeNaturalType>::fillLSBs(offset))|((data>>offset)<<(offset+length)));
+        } else if(srcBitVector.state != Fragmented && BitVectorBucket::isBucketAllocatable(size)) {
             state = InBucket;
-            bucketType = BitVectorBucket::getType(size);
-            srcBitVector.bucketType = BitVectorBucket::getType(size-length);
-            if(srcBitVector.state == Empty || bucketType != srcBitVector.bucketType)
-                allocateInBucket(size);
-            else {
-                bucket->setSize(indexInBucket, size);
-                interoperation<1>(*this, offset+length, offset, size-length-offset);
-            }
+            bucketType = BitVectorBucket::getType(max(size, reservedCapacity));
+            allocateInBucket(size);
         } else {
             BpTreeBitVector::Iterator<true> iter;
             state = Fragmented;
             if(srcBitVector.state == Fragmented) {
+                unshare();
                 bpTree.find<Rank>(iter, offset);
                 bpTree.insert(iter, length, nullptr);
             } else {
@@ -308,17 +585,26 @@ struct BitVector {
             case Empty:
                 location.insertAddress(address);
                 break;
-            case InBucket:
-                if(state != InBucket || bucketType != srcBitVector.bucketType) {
+            case Inline:
+                if(state != Inline) {
                     interoperation(srcBitVector, 0, 0, offset);
                     interoperation(srcBitVector, offset+length, offset, size-length-offset);
-                    srcBitVector.freeFromBucket();
-                } else
+                }
+                location.setAddress(address);
+                break;
+            case InBucket:
+                if(isInPlaceOf(srcBitVector))
                     break;
+                interoperation(srcBitVector, 0, 0, offset);
+                interoperation(srcBitVector, offset+length, offset, size-length-offset);
+                srcBitVector.freeFromBucket();
             case Fragmented:
                 location.setAddress(address);
                 break;
+            case Mapped:
+                assert(false);
         }
+        reservedCapacity = 0;
         assert(size == getSize());
         return true;
     }
@@ -331,6 +617,27 @@ struct BitVector {
         interoperation(src, 0, 0, srcSize);
     }
 
+    // Fragmented sources share their whole tree, which the first write through any of the sharing BitVectors copies completely.
+    // Sharing single pages would need a reference count per page and leaves can not share their sibling links.
+    void clone(BitVector src) {
+        if(location == src.location)
+            return;
+        if(src.state != Fragmented) {
+            deepCopy(src);
+            return;
+        }
+        setSize(0);
+        state = Fragmented;
+        bpTree = src.bpTree;
+        address = src.address;
+        location.insertAddress(address);
+        BpTreeMap<PageRefType, NativeNaturalType>::Iterator<true> iter;
+        if(superPage->sharedBitVectors.find<Key>(iter, bpTree.rootPageRef))
+            iter.setValue(iter.getValue()+1);
+        else
+            superPage->sharedBitVectors.insert(bpTree.rootPageRef, 1);
+    }
+
     bool replaceSlice(BitVector src, NativeNaturalType dstOffset, NativeNaturalType srcOffset, NativeNaturalType length) {
         if(location == src.location && dstOffset == srcOffset)
             return false;
@@ -344,41 +651,154 @@ struct BitVector {
         return true;
     }
 
+    void swapSlices(NativeNaturalType lowerOffset, NativeNaturalType higherOffset, NativeNaturalType length) {
+        NativeNaturalType buffer[64];
+        for(NativeNaturalType offset = 0; offset < length; offset += sizeof(buffer)*8) {
+            NativeNaturalType sliceLength = min(length-offset, static_cast<NativeNaturalType>(sizeof(buffer)*8));
+            externalOperate<false>(buffer, lowerOffset+offset, sliceLength);
+            interoperation(*this, lowerOffset+offset, higherOffset+offset, sliceLength);
+            externalOperate<true>(buffer, higherOffset+offset, sliceLength);
+        }
+    }
+
     bool moveSlice(NativeNaturalType dstOffset, NativeNaturalType srcOffset, NativeNaturalType length) {
         if(dstOffset == srcOffset || length == 0 || max(dstOffset, srcOffset)+length > getSize())
             return false;
-        bool upward = dstOffset > srcOffset;
-        if(upward) {
-            NativeNaturalType offsetDiff = dstOffset-srcOffset;
-            if(offsetDiff < length) {
-                dstOffset = srcOffset;
-                srcOffset += length;
-                length = offsetDiff;
-                upward = false;
+        NativeNaturalType offset = min(dstOffset, srcOffset),
+                          lowerLength = (dstOffset > srcOffset) ? length : srcOffset-dstOffset,
+                          higherLength = (dstOffset > srcOffset) ? dstOffset-srcOffset : length;
+        if(state == Fragmented && min(lowerLength, higherLength) >= BpTreeBitVector::Page::leafKeyCount*4) {
+            unshare();
+            BpTreeBitVector slice, rest;
+            slice.init();
+            rest.init();
+            if(lowerLength <= higherLength) {
+                bpTree.split(slice, offset);
+                slice.split(rest, lowerLength);
+                bpTree.join(rest);
+                bpTree.split(rest, offset+higherLength);
+            } else {
+                bpTree.split(slice, offset+lowerLength);
+                slice.split(rest, higherLength);
+                bpTree.join(rest);
+                bpTree.split(rest, offset);
             }
-        } else {
-            NativeNaturalType offsetDiff = srcOffset-dstOffset;
-            if(offsetDiff < length) {
-                srcOffset = dstOffset;
-                dstOffset += length;
-                length = offsetDiff;
-                upward = true;
+            bpTree.join(slice);
+            bpTree.join(rest);
+            address = bpTree.rootPageRef*bitsPerPage;
+            location.setAddress(address);
+            return true;
+        }
+        NativeNaturalType buffer[64];
+        while(lowerLength > sizeof(buffer)*8 && higherLength > sizeof(buffer)*8) {
+            if(lowerLength <= higherLength) {
+                swapSlices(offset, offset+higherLength, lowerLength);
+                higherLength -= lowerLength;
+            } else {
+                swapSlices(offset, offset+lowerLength, higherLength);
+                offset += higherLength;
+                lowerLength -= higherLength;
             }
         }
-        if(upward)
-            dstOffset += length;
-        increaseSize(dstOffset, length);
-        if(!upward)
-            srcOffset += length;
-        interoperation(*this, dstOffset, srcOffset, length);
-        decreaseSize(srcOffset, length);
+        if(lowerLength == 0 || higherLength == 0)
+            return true;
+        if(lowerLength <= higherLength) {
+            externalOperate<false>(buffer, offset, lowerLength);
+            interoperation<-1>(*this, offset, offset+lowerLength, higherLength);
+            externalOperate<true>(buffer, offset+higherLength, lowerLength);
+        } else {
+            externalOperate<false>(buffer, offset+lowerLength, higherLength);
+            interoperation<+1>(*this, offset+higherLength, offset, lowerLength);
+            externalOperate<true>(buffer, offset, higherLength);
+        }
         return true;
     }
 };
 
 
+struct BitVectorCursor {
+    BitVector& bitVector;
+    BpTreeBitVector::Iterator<false> iter;
+    NativeNaturalType offset, segmentBegin, segmentEnd;
+
+    BitVectorCursor(BitVector& _bitVector, NativeNaturalType _offset = 0) :bitVector(_bitVector) {
+        seek(_offset);
+        iter.end = 0;
+        segmentBegin = segmentEnd = 0;
+    }
+
+    void seek(NativeNaturalType _offset) {
+        offset = _offset;
+    }
+
+    bool skip(NativeNaturalType length) {
+        if(offset+length > bitVector.getSize())
+            return false;
+        offset += length;
+        return true;
+    }
+
+    void locate() {
+        if(iter.end == 0 || iter[iter.end-1]->pageRef != bitVector.bpTree.rootPageRef || !iter.validate())
+            bitVector.bpTree.find<Rank>(iter, offset);
+        else
+            bitVector.bpTree.seek<Rank>(iter, offset);
+        segmentBegin = offset-iter[0]->index;
+        segmentEnd = segmentBegin+iter[0]->endIndex;
+    }
+
+    template<bool overwrite>
+    bool operate(typename conditional<overwrite, const void*, void*>::type data, NativeNaturalType length) {
+        typedef typename conditional<overwrite, const NativeNaturalType*, NativeNaturalType*>::type CopyType0;
+        typedef typename conditional<overwrite, NativeNaturalType*, const NativeNaturalType*>::type CopyType1;
+        if(bitVector.state != BitVector::Fragmented) {
+            if(!bitVector.template externalOperate<overwrite>(data, offset, length))
+                return false;
+            offset += length;
+            return true;
+        }
+        if(length == 0 || offset+length > bitVector.getSize())
+            return false;
+        if(overwrite)
+            bitVector.unshare();
+        if(!iter.validate() || iter[iter.end-1]->pageRef != bitVector.bpTree.rootPageRef)
+            segmentEnd = segmentBegin;
+        NativeNaturalType dataOffset = 0;
+        while(length > 0) {
+            if(offset < segmentBegin || offset >= segmentEnd)
+                locate();
+            NativeNaturalType segment = min(length, segmentEnd-offset);
+            BpTreeBitVector::Page* page = BpTreeBitVector::getPage(iter[0]->pageRef);
+            if(overwrite)
+                page->header.lock();
+            bitwiseCopySwap<overwrite>(reinterpret_cast<CopyType0>(data), reinterpret_cast<CopyType1>(superPage), dataOffset,
+                                       iter[0]->pageRef*bitsPerPage+BpTreeBitVector::Page::valueOffset+offset-segmentBegin, segment);
+            if(overwrite) {
+                page->header.unlock();
+                iter[0]->version = page->header.readVersion();
+            } else if(!iter.validate()) {
+                segmentEnd = segmentBegin;
+                continue;
+            }
+            offset += segment;
+            dataOffset += segment;
+            length -= segment;
+        }
+        return true;
+    }
+
+    bool read(void* data, NativeNaturalType length) {
+        return operate<false>(data, length);
+    }
+
+    bool write(const void* data, NativeNaturalType length) {
+        return operate<true>(data, length);
+    }
+};
 
-SymbolSpace::SymbolSpace(Symbol _spaceSymbol) :spaceSymbol(_spaceSymbol) {
+SymbolSpace::SymbolSpace(Symbol _spaceSymbol) :spaceSymbol(_spaceSymbol), addressCacheEpoch(0) {
+    for(NativeNaturalType i = 0; i < addressCacheSize; ++i)
+        addressCache[i] = {0, i+1, 0}; // Never matches, as symbol i+1 maps to another slot
     BpTreeMap<Symbol, SymbolSpaceState>::Iterator<true> iter;
     if(!superPage->symbolSpaces.find<Key>(iter, spaceSymbol)) {
         state.symbolsEnd = 0;
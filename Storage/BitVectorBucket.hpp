@@ -7,16 +7,12 @@ struct BitVectorBucketHeader : public BasePage {
 struct BitVectorBucket {
     BitVectorBucketHeader header;
 
-    NativeNaturalType getMinDataBits() const {
-        return (header.type == 0) ? 0 : bitVectorBucketType[header.type-1];
-    }
-
     NativeNaturalType getMaxDataBits() const {
         return bitVectorBucketType[header.type];
     }
 
     NativeNaturalType getSizeBits() const {
-        return BitMask<NativeNaturalType>::ceilLog2(getMaxDataBits()-getMinDataBits());
+        return BitMask<NativeNaturalType>::ceilLog2(getMaxDataBits()+1);
     }
 
     NativeNaturalType getHeaderEnd() const {
@@ -52,8 +48,7 @@ struct BitVectorBucket {
     }
 
     void setSize(NativeNaturalType index, NativeNaturalType size) {
-        assert(size > getMinDataBits() && size <= getMaxDataBits());
-        size -= getMinDataBits()+1;
+        assert(size <= getMaxDataBits());
         bitwiseCopy<-1>(reinterpret_cast<NativeNaturalType*>(this),
                         reinterpret_cast<const NativeNaturalType*>(&size),
                         getSizeOffset(index), 0, getSizeBits());
@@ -64,7 +59,7 @@ struct BitVectorBucket {
         bitwiseCopy<-1>(reinterpret_cast<NativeNaturalType*>(&size),
                         reinterpret_cast<const NativeNaturalType*>(this),
                         0, getSizeOffset(index), getSizeBits());
-        return size+getMinDataBits()+1;
+        return size;
     }
 
     void setLocation(NativeNaturalType index, Pair<NativeNaturalType, NativeNaturalType> location) {
@@ -89,16 +84,36 @@ struct BitVectorBucket {
         stats.inhabitedPayload += getMaxDataBits()*header.count;
     }
 
+    void updateStats(bool remove) {
+        Stats delta = {}, &stats = getStats((isFull()) ? FullBucketsStats : FreeBucketsStats);
+        generateStats(delta);
+        if(remove) {
+            stats.uninhabitable -= delta.uninhabitable;
+            stats.totalMetaData -= delta.totalMetaData;
+            stats.inhabitedMetaData -= delta.inhabitedMetaData;
+            stats.totalPayload -= delta.totalPayload;
+            stats.inhabitedPayload -= delta.inhabitedPayload;
+        } else {
+            stats.uninhabitable += delta.uninhabitable;
+            stats.totalMetaData += delta.totalMetaData;
+            stats.inhabitedMetaData += delta.inhabitedMetaData;
+            stats.totalPayload += delta.totalPayload;
+            stats.inhabitedPayload += delta.inhabitedPayload;
+        }
+    }
+
     void init(NativeNaturalType type) {
         header.type = type;
         header.count = 0;
         header.freeIndex = 0;
         for(NativeNaturalType index = 0; index < getMaxElementCount(); ++index)
             setLocation(index, {0, index+1});
+        updateStats(false);
     }
 
     void freeIndex(NativeNaturalType index, PageRefType pageRef) {
         assert(getSize(index) > 0);
+        updateStats(true);
         if(isFull()) {
             assert(superPage->fullBitVectorBuckets.erase<Key>(pageRef));
             assert(superPage->freeBitVectorBuckets[header.type].insert(pageRef));
@@ -110,11 +125,13 @@ struct BitVectorBucket {
         } else {
             setLocation(index, {0, header.freeIndex});
             header.freeIndex = index;
+            updateStats(false);
         }
     }
 
     NativeNaturalType allocateIndex(NativeNaturalType size, Symbol spaceSymbol, Symbol symbol, PageRefType pageRef) {
         assert(size > 0 && header.count < getMaxElementCount());
+        updateStats(true);
         ++header.count;
         NativeNaturalType index = header.freeIndex;
         header.freeIndex = getSymbol(header.freeIndex);
@@ -124,6 +141,7 @@ struct BitVectorBucket {
             assert(superPage->fullBitVectorBuckets.insert(pageRef));
             assert(superPage->freeBitVectorBuckets[header.type].erase<Key>(pageRef));
         }
+        updateStats(false);
         return index;
     }
 
@@ -141,6 +159,10 @@ struct BitVectorBucket {
         });
     }
 
+    static bool isShrinkable(NativeNaturalType type, NativeNaturalType size) {
+        return type >= 2 && size <= bitVectorBucketType[type-2];
+    }
+
     static bool isBucketAllocatable(NativeNaturalType size) {
         return size <= bitVectorBucketType[bitVectorBucketTypeCount-1];
     }
@@ -1,8 +1,8 @@
 #include <Storage/BpTree.hpp>
 
-template<typename KeyType, typename ValueType>
-struct BpTreeMap : public BpTree<KeyType, VoidType, sizeOfInBits<ValueType>::value> {
-    typedef BpTree<KeyType, VoidType, sizeOfInBits<ValueType>::value> Super;
+template<typename KeyType, typename ValueType, typename Augmentation = NoAugmentation, NativeNaturalType edgeFillPercent = 50, NativeNaturalType statsCategory = MetaStructsStats>
+struct BpTreeMap : public BpTree<KeyType, VoidType, sizeOfInBits<ValueType>::value, Augmentation, edgeFillPercent, statsCategory> {
+    typedef BpTree<KeyType, VoidType, sizeOfInBits<ValueType>::value, Augmentation, edgeFillPercent, statsCategory> Super;
     typedef typename Super::IteratorFrame FrameType;
 
     template<bool enableModification>
@@ -21,11 +21,37 @@ struct BpTreeMap : public BpTree<KeyType, VoidType, sizeOfInBits<ValueType>::val
 
         void setValue(ValueType value) {
             static_assert(enableModification);
-            FrameType* frame = (*this)[0];
-            Super::getPage(frame->pageRef)->template set<ValueType, Super::Page::valueOffset>(frame->index, value);
+            auto page = Super::getPage((*this)[0]->pageRef);
+            page->header.lock();
+            page->template set<ValueType, Super::Page::valueOffset>((*this)[0]->index, value);
+            page->header.unlock();
+            SuperIterator::updateAugmentation();
         }
     };
 
+    bool findValue(KeyType key, ValueType& value) {
+        Iterator<false> iter;
+        while(true) {
+            bool result = Super::template find<Key>(iter, key);
+            if(iter.end == 0)
+                return false;
+            if(result)
+                value = iter.getValue();
+            if(iter.validate())
+                return result;
+        }
+    }
+
+    void findValues(const KeyType* keys, NativeNaturalType n, Closure<void(NativeNaturalType, ValueType)> callback) {
+        Super::template findBatch<Key>(keys, n, [&](NativeNaturalType at, typename Super::template Iterator<false>& iter) {
+            ValueType value = static_cast<Iterator<false>&>(iter).getValue();
+            if(!iter.validate())
+                return false;
+            callback(at, value);
+            return true;
+        });
+    }
+
     void insert(Iterator<true>& iter, KeyType key, ValueType value) {
         Super::insert(iter, 1, [&](typename Super::Page* page, typename Super::OffsetType index, typename Super::OffsetType endIndex) {
             assert(index+1 == endIndex);
@@ -41,11 +67,20 @@ struct BpTreeMap : public BpTree<KeyType, VoidType, sizeOfInBits<ValueType>::val
         insert(iter, key, value);
         return true;
     }
+
+    NativeNaturalType insertSorted(const KeyType* keys, const ValueType* values, NativeNaturalType n) {
+        return Super::insertSorted(n, [&](NativeNaturalType at) {
+            return keys[at];
+        }, [&](typename Super::Page* page, typename Super::OffsetType index, NativeNaturalType at) {
+            page->template setKey<true>(index, keys[at]);
+            page->template set<ValueType, Super::Page::valueOffset>(index, values[at]);
+        });
+    }
 };
 
-template<typename KeyType>
-struct BpTreeSet : public BpTree<KeyType, VoidType, 0> {
-    typedef BpTree<KeyType, VoidType, 0> Super;
+template<typename KeyType, NativeNaturalType edgeFillPercent = 50, NativeNaturalType statsCategory = MetaStructsStats>
+struct BpTreeSet : public BpTree<KeyType, VoidType, 0, NoAugmentation, edgeFillPercent, statsCategory> {
+    typedef BpTree<KeyType, VoidType, 0, NoAugmentation, edgeFillPercent, statsCategory> Super;
     typedef typename Super::template Iterator<true> SuperIterator;
 
     template<FindMode mode, bool erase>
@@ -73,8 +108,16 @@ struct BpTreeSet : public BpTree<KeyType, VoidType, 0> {
         insert(iter, key);
         return true;
     }
+
+    NativeNaturalType insertSorted(const KeyType* keys, NativeNaturalType n) {
+        return Super::insertSorted(n, [&](NativeNaturalType at) {
+            return keys[at];
+        }, [&](typename Super::Page* page, typename Super::OffsetType index, NativeNaturalType at) {
+            page->template setKey<true>(index, keys[at]);
+        });
+    }
 };
 
-struct BpTreeBitVector : public BpTree<VoidType, NativeNaturalType, 1> {
-    typedef BpTree<VoidType, NativeNaturalType, 1> Super;
+struct BpTreeBitVector : public BpTree<VoidType, NativeNaturalType, 1, NoAugmentation, 100, FragmentedStats> {
+    typedef BpTree<VoidType, NativeNaturalType, 1, NoAugmentation, 100, FragmentedStats> Super;
 };
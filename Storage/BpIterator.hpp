@@ -28,6 +28,22 @@ struct Iterator {
         return true;
     }
 
+    bool validate() {
+        if(end == 0)
+            return false;
+        for(LayerType layer = end; layer > 0; --layer) {
+            FrameType* frame = (*this)[layer-1];
+            if(frame->pageRef >= getPagesEnd() || !getPage(frame->pageRef)->header.validateVersion(frame->version))
+                return false;
+        }
+        return true;
+    }
+
+    NativeNaturalType invalidate(NativeNaturalType steps) {
+        end = 0;
+        return max(steps, static_cast<NativeNaturalType>(1));
+    }
+
     template<bool srcEnableModification>
     void copy(Iterator<srcEnableModification>& src) {
         static_assert(!enableModification || srcEnableModification);
@@ -51,7 +67,7 @@ struct Iterator {
         }
     }
 
-    void descend(FrameType*& frame, Page*& page, LayerType& layer) {
+    bool descend(FrameType*& frame, Page*& page, LayerType& layer) {
         auto parentFrame = frame;
         auto parentPage = page;
         frame = (*this)[--layer];
@@ -61,8 +77,23 @@ struct Iterator {
                 frame->rank += page->getRank(parentFrame->index-1);
         }
         frame->pageRef = parentPage->getPageRef(parentFrame->index);
+        if(!enableModification) {
+            if(!parentPage->header.validateVersion(parentFrame->version) || frame->pageRef >= getPagesEnd())
+                return false;
+            page = getPage(frame->pageRef);
+            frame->version = page->header.readVersion();
+            return page->isConsistent(layer);
+        }
         page = getPage<enableModification>(frame->pageRef);
         parentPage->setPageRef(parentFrame->index, frame->pageRef);
+        return true;
+    }
+
+    template<NativeIntegerType dir>
+    static void prefetchLeafSibling(Page* page) {
+        PageRefType pageRef = page->template getLeafSibling<dir>();
+        if(pageRef && pageRef < getPagesEnd())
+            __builtin_prefetch(getPage(pageRef));
     }
 
     template<NativeIntegerType dir = 1>
@@ -83,6 +114,37 @@ struct Iterator {
             }
             steps -= stepsTaken;
             keepRunning = false;
+            if(steps > 0 && atLayer == 0 && end > 1) {
+                FrameType* parentFrame = (*this)[1];
+                if((dir == -1 && parentFrame->index > 0) ||
+                   (dir == 1 && parentFrame->index+1 < parentFrame->endIndex)) {
+                    parentFrame->index += dir;
+                    --steps;
+                    if(dir == 1)
+                        frame->rank += static_cast<RankType>(frame->endIndex);
+                    frame->pageRef = getPage(frame->pageRef)->template getLeafSibling<dir>();
+                    if(!enableModification && (frame->pageRef == 0 || frame->pageRef >= getPagesEnd()))
+                        return invalidate(steps);
+                    Page* page = getPage<enableModification>(frame->pageRef);
+                    if(!enableModification) {
+                        frame->version = page->header.readVersion();
+                        if(!page->isConsistent(0))
+                            return invalidate(steps);
+                    }
+                    frame->endIndex = page->header.count;
+                    if(dir == 1)
+                        frame->index = 0;
+                    else {
+                        frame->index = frame->endIndex-1;
+                        frame->rank = frame->rank-static_cast<RankType>(frame->endIndex);
+                    }
+                    prefetchLeafSibling<dir>(page);
+                    if(pageTouchCallback)
+                        pageTouchCallback(page);
+                    keepRunning = true;
+                    continue;
+                }
+            }
             if(steps > 0)
                 while(++layer < end) {
                     frame = (*this)[layer];
@@ -96,15 +158,18 @@ struct Iterator {
                 }
             if(keepRunning || stepsTaken > 0) {
                 Page* page = getPage(frame->pageRef);
-                layer = page->header.layer;
+                layer = min(layer, static_cast<LayerType>(end-1));
                 LayerType endLayer = (atLayer) ? atLayer-1 : 0;
                 while(layer > endLayer) {
-                    descend(frame, page, layer);
+                    if(!descend(frame, page, layer))
+                        return invalidate(steps);
                     frame->endIndex = page->header.count;
                     frame->index = (dir == 1) ? 0 : frame->endIndex-1;
                     if(pageTouchCallback)
                         pageTouchCallback(page);
                 }
+                if(atLayer == 0 && keepRunning)
+                    prefetchLeafSibling<dir>(page);
             }
         } while(keepRunning);
         return steps;
@@ -124,28 +189,34 @@ struct Iterator {
 
     void setKey(KeyType key) {
         static_assert(keyBits && enableModification);
-        FrameType* frame = (*this)[0];
-        getPage(frame->pageRef)->template setKey<true>(frame->index, key);
+        Page* page = getPage((*this)[0]->pageRef);
+        page->header.lock();
+        page->template setKey<true>((*this)[0]->index, key);
+        page->header.unlock();
+    }
+
+    void updateAugmentation() {
+        static_assert(enableModification);
+        if(!augmentBits || end < 2)
+            return;
+        Page* root = getPage((*this)[end-1]->pageRef);
+        root->header.lock();
+        for(LayerType layer = 1; layer < end; ++layer)
+            getPage((*this)[layer]->pageRef)->setAugmentation((*this)[layer]->index, getPage((*this)[layer-1]->pageRef)->getIntegratedAugmentation());
+        root->header.unlock();
     }
 };
 
 template<FindMode mode, bool enableModification>
-bool find(Iterator<enableModification>& iter,
-          typename conditional<mode == Rank, RankType, KeyType>::type keyOrRank = 0,
-          Closure<void(Page*)> pageTouchCallback = nullptr) {
-    static_assert(mode != Key || keyBits);
-    static_assert(mode != Rank || rankBits);
-    if(isEmpty()) {
-        iter.end = 0;
-        return false;
-    }
-    bool result;
-    Page* page = getPage<enableModification>(rootPageRef);
-    LayerType layer = page->header.layer;
-    iter.end = layer+1;
+bool findBelow(Iterator<enableModification>& iter, LayerType layer,
+               typename conditional<mode == Rank, RankType, KeyType>::type keyOrRank,
+               Closure<void(Page*)> pageTouchCallback, bool& result) {
     auto frame = iter[layer];
-    frame->rank = 0;
-    frame->pageRef = rootPageRef;
+    if(!enableModification && frame->pageRef >= getPagesEnd())
+        return false;
+    Page* page = getPage(frame->pageRef);
+    if(!enableModification && !page->isConsistent(layer))
+        return false;
     while(true) {
         frame->endIndex = page->header.count;
         if(layer == 0) {
@@ -162,16 +233,19 @@ bool find(Iterator<enableModification>& iter,
                     frame->index = binarySearch<OffsetType>(0, page->template keyCount<true>(), [&](OffsetType at) {
                         return static_cast<KeyType>(keyOrRank) > page->template getKey<true>(at);
                     });
-                    result = frame->index < page->header.count && static_cast<KeyType>(keyOrRank) == page->template getKey<true>(frame->index);
+                    result = frame->index < frame->endIndex && static_cast<KeyType>(keyOrRank) == page->template getKey<true>(frame->index);
                     break;
                 case Rank:
                     frame->index = static_cast<RankType>(keyOrRank)-frame->rank;
-                    result = frame->index < page->header.count;
+                    result = frame->index < frame->endIndex;
                     break;
             }
+            if(!enableModification && (__atomic_load_n(&rootPageRef, __ATOMIC_ACQUIRE) != iter[iter.end-1]->pageRef ||
+                                       !getPage(iter[iter.end-1]->pageRef)->header.validateVersion(iter[iter.end-1]->version)))
+                return false;
             if(pageTouchCallback)
                 pageTouchCallback(page);
-            return result;
+            return true;
         } else {
             switch(mode) {
                 case First:
@@ -193,8 +267,130 @@ bool find(Iterator<enableModification>& iter,
             }
             if(pageTouchCallback)
                 pageTouchCallback(page);
-            iter.descend(frame, page, layer);
+            if(!iter.descend(frame, page, layer))
+                return false;
+        }
+    }
+}
+
+template<FindMode mode, bool enableModification>
+bool find(Iterator<enableModification>& iter,
+          typename conditional<mode == Rank, RankType, KeyType>::type keyOrRank = 0,
+          Closure<void(Page*)> pageTouchCallback = nullptr) {
+    static_assert(mode != Key || keyBits);
+    static_assert(mode != Rank || rankBits);
+    while(true) {
+        PageRefType pageRef = (enableModification) ? rootPageRef : __atomic_load_n(&rootPageRef, __ATOMIC_ACQUIRE);
+        if(pageRef == 0) {
+            iter.end = 0;
+            return false;
+        }
+        if(!enableModification && pageRef >= getPagesEnd())
+            continue;
+        bool result;
+        Page* page = getPage<enableModification>((enableModification) ? rootPageRef : pageRef);
+        NativeNaturalType version = (enableModification) ? 0 : page->header.readVersion();
+        LayerType layer = page->header.layer;
+        if(!enableModification && layer >= maxLayerCount)
+            continue;
+        iter.end = layer+1;
+        auto frame = iter[layer];
+        frame->rank = 0;
+        frame->pageRef = (enableModification) ? rootPageRef : pageRef;
+        frame->version = version;
+        if(findBelow<mode>(iter, layer, keyOrRank, pageTouchCallback, result))
+            return result;
+    }
+}
+
+template<FindMode mode, bool enableModification>
+LayerType ascend(Iterator<enableModification>& iter, typename conditional<mode == Rank, RankType, KeyType>::type keyOrRank) {
+    LayerType candidate = 0;
+    if(mode == Rank) {
+        for(; candidate+1 < iter.end; ++candidate) {
+            auto frame = iter[candidate];
+            if(static_cast<RankType>(keyOrRank) >= frame->rank &&
+               getPage(frame->pageRef)->getIntegratedRank() > static_cast<RankType>(keyOrRank)-frame->rank)
+                break;
+        }
+        return candidate;
+    }
+    bool lowerBoundPending = true, higherBoundPending = true;
+    for(LayerType layer = 1; layer < iter.end && (lowerBoundPending || higherBoundPending); ++layer) {
+        auto frame = iter[layer];
+        Page* page = getPage(frame->pageRef);
+        if(lowerBoundPending && frame->index > 0) {
+            if(static_cast<KeyType>(keyOrRank) >= page->template getKey<false>(frame->index-1))
+                lowerBoundPending = false;
+            else {
+                candidate = layer;
+                higherBoundPending = true;
+                continue;
+            }
+        }
+        if(higherBoundPending && frame->index+1 < frame->endIndex) {
+            if(static_cast<KeyType>(keyOrRank) >= page->template getKey<false>(frame->index)) {
+                candidate = layer;
+                lowerBoundPending = true;
+            } else
+                higherBoundPending = false;
+        }
+    }
+    return candidate;
+}
+
+template<FindMode mode, bool enableModification>
+bool seek(Iterator<enableModification>& iter, typename conditional<mode == Rank, RankType, KeyType>::type keyOrRank) {
+    static_assert(mode == Key || mode == Rank);
+    bool result;
+    if(iter.end == 0 || !findBelow<mode>(iter, ascend<mode>(iter, keyOrRank), keyOrRank, nullptr, result))
+        result = find<mode>(iter, keyOrRank);
+    return result;
+}
+
+// The callback returns false if the iterator failed to validate after its read, the lookup is then repeated
+template<FindMode mode>
+void findBatch(const typename conditional<mode == Rank, RankType, KeyType>::type* keysOrRanks, NativeNaturalType n,
+               Closure<bool(NativeNaturalType, Iterator<false>&)> callback) {
+    static_assert(mode == Key || mode == Rank);
+    Iterator<false> iter;
+    iter.end = 0;
+    for(NativeNaturalType at = 0; at < n; ++at) {
+        assert(at == 0 || keysOrRanks[at] >= keysOrRanks[at-1]);
+        while(seek<mode>(iter, keysOrRanks[at]) && !callback(at, iter))
+            iter.end = 0;
+    }
+}
+
+template<FindMode mode>
+AugmentType aggregate(typename conditional<mode == Rank, RankType, KeyType>::type begin,
+                      typename conditional<mode == Rank, RankType, KeyType>::type end) {
+    static_assert(augmentBits && (mode == Key || mode == Rank));
+    Iterator<false> from, to;
+    while(true) {
+        AugmentType result = Augmentation::identity();
+        if(begin >= end)
+            return result;
+        find<mode>(from, begin);
+        find<mode>(to, end);
+        if(from.end == 0)
+            return result;
+        LayerType top = 0;
+        while(from[top]->pageRef != to[top]->pageRef)
+            ++top;
+        if(top == 0)
+            result = getPage(from[0]->pageRef)->template aggregate<true>(from[0]->index, to[0]->index);
+        else {
+            result = getPage(from[0]->pageRef)->template aggregate<true>(from[0]->index, from[0]->endIndex);
+            for(LayerType layer = 1; layer < top; ++layer)
+                result = Augmentation::combine(result, getPage(from[layer]->pageRef)->template aggregate<false>(from[layer]->index+1, from[layer]->endIndex));
+            result = Augmentation::combine(result, getPage(from[top]->pageRef)->template aggregate<false>(from[top]->index+1, to[top]->index));
+            for(LayerType layer = top-1; layer > 0; --layer)
+                result = Augmentation::combine(result, getPage(to[layer]->pageRef)->template aggregate<false>(0, to[layer]->index));
+            result = Augmentation::combine(result, getPage(to[0]->pageRef)->template aggregate<true>(0, to[0]->index));
         }
+        if(from.validate() && to.validate())
+            return result;
     }
 }
 
@@ -1,4 +1,5 @@
 struct PageHeader : public BasePage {
+    PageRefType lowerLeafPageRef, higherLeafPageRef;
     OffsetType count;
     LayerType layer;
 };
@@ -10,9 +11,10 @@ struct Page {
         headerBits = sizeOfInBits<PageHeader>::value,
         keyOffset = architecturePadding(headerBits),
         bodyBits = bitsPerPage-keyOffset,
-        branchKeyCount = (bodyBits-rankBits-pageRefBits)/(keyBits+rankBits+pageRefBits),
+        branchKeyCount = (bodyBits-rankBits-augmentBits-pageRefBits)/(keyBits+rankBits+augmentBits+pageRefBits),
         leafKeyCount = bodyBits/(keyBits+valueBits),
         rankOffset = keyOffset+keyBits*branchKeyCount,
+        augmentOffset = rankOffset+rankBits*(branchKeyCount+1),
         pageRefOffset = bitsPerPage-pageRefBits*(branchKeyCount+1),
         valueOffset = bitsPerPage-valueBits*leafKeyCount;
 
@@ -32,6 +34,11 @@ struct Page {
         return (isLeaf) ? leafKeyCount : branchKeyCount+1;
     }
 
+    bool isConsistent(LayerType layer) const {
+        OffsetType count = header.count;
+        return header.layer == layer && count > 0 && count <= ((layer) ? capacity<false>() : capacity<true>());
+    }
+
     template<bool isLeaf>
     OffsetType keyCount() const {
         return (isLeaf) ? header.count : header.count-1;
@@ -52,6 +59,10 @@ struct Page {
         return get<RankType, rankOffset>(src);
     }
 
+    AugmentType getAugmentation(OffsetType src) const {
+        return get<AugmentType, augmentOffset>(src);
+    }
+
     PageRefType getPageRef(OffsetType src) const {
         return get<PageRefType, pageRefOffset>(src);
     }
@@ -71,6 +82,10 @@ struct Page {
         set<RankType, rankOffset>(dst, content);
     }
 
+    void setAugmentation(OffsetType dst, AugmentType content) {
+        set<AugmentType, augmentOffset>(dst, content);
+    }
+
     void setPageRef(OffsetType dst, PageRefType content) {
         set<PageRefType, pageRefOffset>(dst, content);
     }
@@ -104,10 +119,36 @@ struct Page {
         setRank(begin, higher-getRank(begin-1));
     }
 
+    template<NativeIntegerType dir>
+    PageRefType getLeafSibling() const {
+        return (dir == 1) ? header.higherLeafPageRef : header.lowerLeafPageRef;
+    }
+
+    static void linkLeaves(PageRefType lowerPageRef, PageRefType higherPageRef) {
+        if(lowerPageRef)
+            dereferencePage<Page>(lowerPageRef)->header.higherLeafPageRef = higherPageRef;
+        if(higherPageRef)
+            dereferencePage<Page>(higherPageRef)->header.lowerLeafPageRef = lowerPageRef;
+    }
+
     RankType getIntegratedRank() {
         return (header.layer == 0) ? static_cast<RankType>(header.count) : getRank(header.count-1);
     }
 
+    template<bool isLeaf>
+    AugmentType aggregate(OffsetType begin, OffsetType end) const {
+        if(isLeaf)
+            return Augmentation::aggregate(this, begin, end);
+        AugmentType result = Augmentation::identity();
+        for(; begin < end; ++begin)
+            result = Augmentation::combine(result, getAugmentation(begin));
+        return result;
+    }
+
+    AugmentType getIntegratedAugmentation() const {
+        return (header.layer == 0) ? aggregate<true>(0, header.count) : aggregate<false>(0, header.count);
+    }
+
     template<bool frontKey, NativeIntegerType dir = -1>
     static void copyBranchElements(Page* dstPage, Page* srcPage,
                                    OffsetType dstIndex, OffsetType srcIndex,
@@ -120,6 +161,12 @@ struct Page {
                              rankOffset+dstIndex*rankBits,
                              rankOffset+srcIndex*rankBits,
                              n*rankBits);
+        if(augmentBits)
+            bitwiseCopy<dir>(reinterpret_cast<NativeNaturalType*>(dstPage),
+                             reinterpret_cast<const NativeNaturalType*>(srcPage),
+                             augmentOffset+dstIndex*augmentBits,
+                             augmentOffset+srcIndex*augmentBits,
+                             n*augmentBits);
         bitwiseCopy<dir>(reinterpret_cast<NativeNaturalType*>(dstPage),
                          reinterpret_cast<const NativeNaturalType*>(srcPage),
                          pageRefOffset+dstIndex*pageRefBits,
@@ -188,6 +235,17 @@ struct Page {
         higher->header.count = n/2;
     }
 
+    template<bool isLeaf>
+    static void splitCount(Page* lower, Page* higher, OffsetType n, NativeIntegerType edge) {
+        OffsetType count = min(static_cast<OffsetType>(capacity<isLeaf>()*edgeFillPercent/100), static_cast<OffsetType>(n-((isLeaf) ? 1 : 2)));
+        if(edgeFillPercent == 50 || edge == 0 || count <= n/2)
+            distributeCount(lower, higher, n);
+        else {
+            lower->header.count = (edge == 1) ? count : n-count;
+            higher->header.count = n-lower->header.count;
+        }
+    }
+
     template<bool isLeaf>
     static void insert(InsertIteratorFrame* frame, Page* lowerOuter, OffsetType count) {
         assert(count > lowerOuter->header.count && count <= capacity<isLeaf>() && frame->index <= lowerOuter->header.count);
@@ -210,7 +268,7 @@ struct Page {
         assert(lowerOuter->header.count >= frame->index);
         assert(frame->endIndex <= capacity<isLeaf>()*2);
         lowerInner->header.count = higherInner->header.count = frame->elementsPerPage;
-        distributeCount(lowerOuter, higherOuter, frame->endIndex);
+        splitCount<isLeaf>(lowerOuter, higherOuter, frame->endIndex, frame->edge);
         if(shiftHigherInner < lowerOuter->header.count) {
             shiftHigherInner = lowerOuter->header.count-shiftHigherInner;
             assert(shiftHigherInner < higherInner->header.count);
@@ -236,7 +294,7 @@ struct Page {
                 copyKey<false, true>(higherOuterParent, higherOuter, higherOuterParentIndex, 0);
         } else {
             if(frame->lowerInnerIndex > 0) {
-                lowerOuter->decumulateRanks(lowerOuter->header.count, frame->rank);
+                lowerOuter->decumulateRanks(lowerOuter->header.count, frame->integrateIndex);
                 copyKey<false, false>(lowerInnerParent, lowerOuter, lowerInnerParentIndex, lowerOuter->header.count-1);
                 copyBranchElements<false>(lowerInner, lowerOuter, 0, lowerOuter->header.count, frame->lowerInnerIndex);
                 copyBranchElements<true>(higherOuter, lowerOuter, frame->higherOuterEndIndex, frame->index+shiftHigherInner, shiftHigherOuter);
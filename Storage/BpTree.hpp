@@ -7,18 +7,92 @@ enum FindMode {
     Rank
 };
 
-template<typename KeyType, typename RankType, NativeNaturalType valueBits>
+struct NoAugmentation {
+    typedef VoidType Type;
+    static Type identity() {
+        return Type();
+    }
+    static Type combine(Type lower, Type higher) {
+        return lower;
+    }
+    template<typename PageType, typename OffsetType>
+    static Type aggregate(const PageType* page, OffsetType begin, OffsetType end) {
+        return Type();
+    }
+};
+
+template<typename ValueType>
+struct SumAugmentation {
+    typedef ValueType Type;
+    static Type identity() {
+        return 0;
+    }
+    static Type combine(Type lower, Type higher) {
+        return lower+higher;
+    }
+    template<typename PageType, typename OffsetType>
+    static Type aggregate(const PageType* page, OffsetType begin, OffsetType end) {
+        Type result = 0;
+        for(; begin < end; ++begin)
+            result += page->template get<ValueType, PageType::valueOffset>(begin);
+        return result;
+    }
+};
+
+template<typename ValueType, bool maximum>
+struct ExtremumAugmentation {
+    typedef ValueType Type;
+    static Type identity() {
+        return (maximum) ? BitMask<ValueType>::empty : BitMask<ValueType>::full;
+    }
+    static Type combine(Type lower, Type higher) {
+        return (maximum) ? max(lower, higher) : min(lower, higher);
+    }
+    template<typename PageType, typename OffsetType>
+    static Type aggregate(const PageType* page, OffsetType begin, OffsetType end) {
+        Type result = identity();
+        for(; begin < end; ++begin)
+            result = combine(result, page->template get<ValueType, PageType::valueOffset>(begin));
+        return result;
+    }
+};
+
+struct PopCountAugmentation {
+    typedef NativeNaturalType Type;
+    static Type identity() {
+        return 0;
+    }
+    static Type combine(Type lower, Type higher) {
+        return lower+higher;
+    }
+    template<typename PageType, typename OffsetType>
+    static Type aggregate(const PageType* page, OffsetType begin, OffsetType end) {
+        Type result = 0;
+        NativeNaturalType offset = PageType::valueOffset+begin;
+        while(begin < end) {
+            NativeNaturalType length = min(static_cast<NativeNaturalType>(end-begin), static_cast<NativeNaturalType>(architectureSize));
+            result += __builtin_popcountll(readSegmentFrom<-1>(reinterpret_cast<const NativeNaturalType*>(page), offset, length));
+            begin += length;
+        }
+        return result;
+    }
+};
+
+template<typename KeyType, typename RankType, NativeNaturalType valueBits, typename Augmentation = NoAugmentation, NativeNaturalType edgeFillPercent = 50, NativeNaturalType statsCategory = MetaStructsStats>
 struct BpTree {
     typedef Natural32 OffsetType;
     typedef Natural8 LayerType;
+    typedef typename Augmentation::Type AugmentType;
 
     static constexpr NativeNaturalType
         keyBits = sizeOfInBits<KeyType>::value,
         rankBits = sizeOfInBits<RankType>::value,
+        augmentBits = sizeOfInBits<AugmentType>::value,
         pageRefBits = sizeOfInBits<PageRefType>::value;
     static_assert(keyBits || rankBits);
     static_assert(pageRefBits);
     static_assert(!rankBits || rankBits >= sizeOfInBits<OffsetType>::value);
+    static_assert(edgeFillPercent >= 50 && edgeFillPercent <= 100);
 
     PageRefType rootPageRef;
 
@@ -45,14 +119,16 @@ struct BpTree {
 
     struct IteratorFrame {
         RankType rank;
-        PageRefType pageRef;
-        OffsetType index, endIndex;
+        PageRefType pageRef = 0;
+        OffsetType index = 0, endIndex = 0;
+        NativeNaturalType version;
     };
 
     struct InsertIteratorFrame : public IteratorFrame {
         PageRefType lowerInnerPageRef, higherInnerPageRef, higherOuterPageRef;
-        OffsetType lowerInnerIndex, higherInnerEndIndex, higherOuterEndIndex, elementsPerPage;
+        OffsetType lowerInnerIndex, higherInnerEndIndex, higherOuterEndIndex, elementsPerPage, integrateIndex;
         NativeNaturalType pageCount;
+        Integer8 edge;
     };
 
 #include <Storage/BpPage.hpp>
@@ -64,6 +140,32 @@ struct BpTree {
         return dereferencePage<Page>(pageRef);
     }
 
+    static constexpr NativeNaturalType
+        leafUninhabitable = Page::valueOffset-keyBits*Page::leafKeyCount-Page::headerBits,
+        branchUninhabitable = Page::keyOffset+Page::pageRefOffset-Page::rankOffset-(rankBits+augmentBits)*(Page::branchKeyCount+1)-Page::headerBits;
+
+    static void updateStats(NativeIntegerType leafPages, NativeIntegerType branchPages, NativeIntegerType elements, NativeIntegerType roots) {
+        Stats& stats = getStats(statsCategory);
+        stats.uninhabitable += leafUninhabitable*leafPages+branchUninhabitable*branchPages;
+        stats.totalMetaData += Page::headerBits*leafPages+(bitsPerPage-branchUninhabitable)*branchPages;
+        stats.totalPayload += (bitsPerPage-leafUninhabitable-Page::headerBits)*leafPages;
+        stats.inhabitedMetaData += Page::headerBits*leafPages+(Page::headerBits+rankBits+augmentBits+pageRefBits)*branchPages+
+                                   (keyBits+rankBits+augmentBits+pageRefBits)*(leafPages+branchPages-roots);
+        stats.inhabitedPayload += (keyBits+valueBits)*elements;
+    }
+
+    template<bool isLeaf>
+    static PageRefType acquirePage() {
+        updateStats(isLeaf, !isLeaf, 0, 0);
+        return ::acquirePage();
+    }
+
+    template<bool isLeaf>
+    static void releasePage(PageRefType pageRef) {
+        updateStats(-isLeaf, -!isLeaf, 0, 0);
+        ::releasePage(pageRef);
+    }
+
     void generateStats(struct Stats& stats, Closure<void(Iterator<false>&)> callback = nullptr) {
         if(isEmpty())
             return;
@@ -78,20 +180,15 @@ struct BpTree {
                         callback(iter);
             } else {
                 ++branchPageCount;
-                stats.inhabitedMetaData += (keyBits+rankBits+pageRefBits)*page->header.count+rankBits+pageRefBits;
+                stats.inhabitedMetaData += (keyBits+rankBits+augmentBits+pageRefBits)*page->header.count+rankBits+augmentBits+pageRefBits;
             }
         };
         find<First>(iter, 0, pageTouch);
         while(iter.template advance<1>(1, 1, pageTouch) == 0);
-        NativeNaturalType uninhabitable = Page::valueOffset-keyBits*Page::leafKeyCount-Page::headerBits;
-        stats.uninhabitable += uninhabitable*leafPageCount;
-        stats.totalPayload += (bitsPerPage-uninhabitable-Page::headerBits)*leafPageCount;
-        stats.totalMetaData += Page::headerBits*leafPageCount;
-        stats.inhabitedMetaData += Page::headerBits*leafPageCount;
-        uninhabitable = Page::keyOffset+Page::pageRefOffset-Page::rankOffset-rankBits*(Page::branchKeyCount+1)-Page::headerBits;
-        stats.uninhabitable += uninhabitable*branchPageCount;
-        stats.totalMetaData += (bitsPerPage-uninhabitable)*branchPageCount;
-        stats.inhabitedMetaData += Page::headerBits*branchPageCount;
+        stats.uninhabitable += leafUninhabitable*leafPageCount+branchUninhabitable*branchPageCount;
+        stats.totalPayload += (bitsPerPage-leafUninhabitable-Page::headerBits)*leafPageCount;
+        stats.totalMetaData += Page::headerBits*leafPageCount+(bitsPerPage-branchUninhabitable)*branchPageCount;
+        stats.inhabitedMetaData += Page::headerBits*(leafPageCount+branchPageCount);
     }
 
     struct InsertData {
@@ -120,31 +217,32 @@ struct BpTree {
         if(data.layer < iter.end) {
             if(!isLeaf) {
                 lowerOuter->decumulateRanks(frame->index, lowerOuter->header.count);
-                frame->rank = frame->index++;
+                frame->integrateIndex = frame->index++;
             }
             if(frame->pageCount == 0) {
                 frame->higherOuterPageRef = 0;
                 Page::template insert<isLeaf>(frame, lowerOuter, data.elementCount);
             } else {
                 frame->endIndex = data.elementCount-(frame->pageCount-1)*frame->elementsPerPage;
-                frame->higherOuterPageRef = acquirePage();
+                frame->higherOuterPageRef = acquirePage<isLeaf>();
                 switch(frame->pageCount) {
                     case 1:
                         frame->lowerInnerPageRef = frame->higherOuterPageRef;
                         frame->higherInnerPageRef = frame->pageRef;
                         break;
                     case 2:
-                        frame->lowerInnerPageRef = acquirePage();
+                        frame->lowerInnerPageRef = acquirePage<isLeaf>();
                         frame->higherInnerPageRef = frame->lowerInnerPageRef;
                         break;
                     default:
-                        frame->lowerInnerPageRef = acquirePage();
-                        frame->higherInnerPageRef = acquirePage();
+                        frame->lowerInnerPageRef = acquirePage<isLeaf>();
+                        frame->higherInnerPageRef = acquirePage<isLeaf>();
                         break;
                 }
             }
         } else {
-            frame->pageRef = acquirePage();
+            frame->edge = (isLeaf) ? 0 : iter[data.layer-1]->edge;
+            frame->pageRef = acquirePage<isLeaf>();
             lowerOuter = getPage(frame->pageRef);
             lowerOuter->header.layer = data.layer;
             if(!isLeaf)
@@ -157,19 +255,19 @@ struct BpTree {
                 if(frame->pageCount <= 1)
                     frame->higherInnerPageRef = 0;
                 else {
-                    frame->higherInnerPageRef = acquirePage();
+                    frame->higherInnerPageRef = acquirePage<isLeaf>();
                     frame->higherInnerEndIndex = frame->elementsPerPage;
                     Page* higherInner = getPage(frame->higherInnerPageRef);
                     higherInner->header.count = frame->elementsPerPage;
                     higherInner->header.layer = data.layer;
                 }
-                frame->higherOuterPageRef = acquirePage();
+                frame->higherOuterPageRef = acquirePage<isLeaf>();
                 Page* higherOuter = getPage(frame->higherOuterPageRef);
                 higherOuter->header.layer = data.layer;
-                Page::distributeCount(lowerOuter, higherOuter, data.elementCount-(frame->pageCount-1)*frame->elementsPerPage);
+                Page::template splitCount<isLeaf>(lowerOuter, higherOuter, data.elementCount-(frame->pageCount-1)*frame->elementsPerPage, frame->edge);
                 frame->higherOuterEndIndex = higherOuter->header.count;
             }
-            frame->rank = 0;
+            frame->integrateIndex = 0;
             frame->index = (isLeaf) ? 0 : 1;
             frame->endIndex = lowerOuter->header.count;
         }
@@ -232,26 +330,26 @@ struct BpTree {
                 frame->pageRef = frame->lowerInnerPageRef;
                 Page* page = getPage(frame->pageRef);
                 frame->index = frame->lowerInnerIndex;
-                frame->rank = (frame->index) ? frame->index-1 : 0;
+                frame->integrateIndex = (frame->index) ? frame->index-1 : 0;
                 frame->endIndex = (frame->lowerInnerPageRef == frame->higherOuterPageRef) ? frame->higherOuterEndIndex : frame->elementsPerPage;
                 frame->lowerInnerPageRef = 0;
                 return page;
             } else if(frame->pageCount == 1) {
                 frame->pageRef = frame->higherInnerPageRef;
                 Page* page = getPage(frame->pageRef);
-                frame->rank = frame->index = 0;
+                frame->integrateIndex = frame->index = 0;
                 frame->endIndex = frame->higherInnerEndIndex;
                 return page;
             } else if(frame->pageCount == 0) {
                 frame->pageRef = frame->higherOuterPageRef;
                 Page* page = getPage(frame->pageRef);
-                frame->rank = frame->index = 0;
+                frame->integrateIndex = frame->index = 0;
                 frame->endIndex = frame->higherOuterEndIndex;
                 return page;
             }
         }
-        frame->pageRef = acquirePage();
-        frame->rank = frame->index = 0;
+        frame->pageRef = acquirePage<isLeaf>();
+        frame->integrateIndex = frame->index = 0;
         frame->endIndex = frame->elementsPerPage;
         Page* page = getPage(frame->pageRef);
         page->header.count = frame->endIndex;
@@ -259,26 +357,40 @@ struct BpTree {
         return page;
     }
 
-    static void insertIntegrateRanks(InsertIteratorFrame* frame, Page* page) {
+    static void insertIntegrate(InsertIteratorFrame* frame, Page* page) {
+        if(augmentBits)
+            for(OffsetType i = frame->integrateIndex; i < frame->endIndex; ++i)
+                page->setAugmentation(i, getPage(page->getPageRef(i))->getIntegratedAugmentation());
         if(!rankBits)
             return;
-        for(OffsetType i = frame->rank; i < frame->endIndex; ++i)
+        for(OffsetType i = frame->integrateIndex; i < frame->endIndex; ++i)
             page->setRank(i, getPage(page->getPageRef(i))->getIntegratedRank());
-        page->cumulateRanks(frame->rank, page->header.count);
+        page->cumulateRanks(frame->integrateIndex, page->header.count);
     }
 
     typedef Closure<void(Page*, OffsetType, OffsetType)> AcquireData;
     void insert(Iterator<true>& _iter, NativeNaturalType n, AcquireData acquireData) {
         assert(n > 0);
+        Page* lockedRoot = (isEmpty()) ? nullptr : getPage(rootPageRef);
+        if(lockedRoot)
+            lockedRoot->header.lock();
+        updateStats(0, 0, n, isEmpty());
         InsertData data = {0, n};
         Iterator<true, InsertIteratorFrame> iter;
         iter.copy(_iter);
+        PageRefType higherLeafPageRef = (iter.end) ? getPage(iter[0]->pageRef)->header.higherLeafPageRef : 0;
+        bool lowestPath = true, highestPath = true;
+        for(LayerType layer = iter.end; layer > 0; ) {
+            InsertIteratorFrame* frame = iter[--layer];
+            highestPath = highestPath && frame->index == ((layer) ? frame->endIndex-1 : frame->endIndex);
+            lowestPath = lowestPath && frame->index == 0;
+            frame->edge = (highestPath) ? 1 : (lowestPath) ? -1 : 0;
+        }
         insertPhase1<true>(data, iter);
         while(insertPhase1<false>(data, iter));
         LayerType unmodifiedLayer = data.layer;
         data.layer = min(iter.end, unmodifiedLayer);
         iter.end = max(iter.end, unmodifiedLayer);
-        rootPageRef = iter[iter.end-1]->pageRef;
         while(data.layer > 0) {
             InsertIteratorFrame* frame = iter[--data.layer];
             if(frame->higherOuterPageRef) {
@@ -296,11 +408,15 @@ struct BpTree {
         }
         PageRefType pageRef;
         Page* leafPage = getPage(iter[0]->pageRef);
+        if(_iter.end == 0)
+            leafPage->header.lowerLeafPageRef = 0;
         if(acquireData && iter[0]->index < iter[0]->endIndex)
             acquireData(leafPage, iter[0]->index, iter[0]->endIndex);
         while(iter[0]->pageCount > 0) {
             data.layer = 0;
+            pageRef = iter[0]->pageRef;
             leafPage = insertAdvance<true>(data, iter[0]);
+            Page::linkLeaves(pageRef, iter[0]->pageRef);
             if(acquireData && iter[0]->index < iter[0]->endIndex)
                 acquireData(leafPage, iter[0]->index, iter[0]->endIndex);
             bool setKey = true;
@@ -314,7 +430,7 @@ struct BpTree {
                     page->setPageRef(frame->index++, pageRef);
                     break;
                 }
-                insertIntegrateRanks(frame, page);
+                insertIntegrate(frame, page);
                 page = insertAdvance<false>(data, frame);
                 if(setKey && frame->index > 0) {
                     Page::template copyKey<false, true>(page, leafPage, frame->index-1, 0);
@@ -324,6 +440,7 @@ struct BpTree {
                 pageRef = frame->pageRef;
             }
         }
+        Page::linkLeaves(iter[0]->pageRef, higherLeafPageRef);
         pageRef = 0;
         for(data.layer = 1; data.layer < unmodifiedLayer; ++data.layer) {
             InsertIteratorFrame* frame = iter[data.layer];
@@ -332,26 +449,74 @@ struct BpTree {
                 page->setPageRef(frame->index++, pageRef);
                 pageRef = 0;
             }
-            insertIntegrateRanks(frame, page);
+            insertIntegrate(frame, page);
             if(frame->pageCount > 0) {
                 assert(frame->higherOuterPageRef);
                 Page* page = insertAdvance<false>(data, frame);
                 if(pageRef)
                     page->setPageRef(frame->index++, pageRef);
-                insertIntegrateRanks(frame, page);
+                insertIntegrate(frame, page);
                 pageRef = frame->pageRef;
             } else
                 pageRef = 0;
         }
-        if(rankBits)
+        if(rankBits || augmentBits)
             for(data.layer = unmodifiedLayer; data.layer < iter.end; ++data.layer) {
                 InsertIteratorFrame* frame = iter[data.layer];
-                frame->rank = frame->index;
+                frame->integrateIndex = frame->index;
                 frame->endIndex = frame->index+1;
                 Page* page = getPage(frame->pageRef);
-                page->decumulateRanks(frame->rank, page->header.count);
-                insertIntegrateRanks(frame, page);
+                page->decumulateRanks(frame->integrateIndex, page->header.count);
+                insertIntegrate(frame, page);
             }
+        __atomic_store_n(&rootPageRef, iter[iter.end-1]->pageRef, __ATOMIC_RELEASE);
+        if(lockedRoot)
+            lockedRoot->header.unlock();
+    }
+
+    typedef Closure<KeyType(NativeNaturalType)> RunKey;
+    typedef Closure<void(Page*, OffsetType, NativeNaturalType)> RunElement;
+    NativeNaturalType insertSorted(NativeNaturalType n, RunKey runKey, RunElement runElement) {
+        static_assert(keyBits);
+        NativeNaturalType at = 0, inserted = 0;
+        Iterator<true> iter, next;
+        while(at < n) {
+            KeyType key = runKey(at);
+            if(find<Key>(iter, key)) {
+                ++at;
+                continue;
+            }
+            bool bounded = false;
+            KeyType bound = key;
+            if(iter.end > 0) {
+                if(iter[0]->index < iter[0]->endIndex) {
+                    bounded = true;
+                    bound = iter.getKey();
+                } else {
+                    next.copy(iter);
+                    next[0]->index = next[0]->endIndex-1;
+                    if(next.advance() == 0) {
+                        bounded = true;
+                        bound = next.getKey();
+                    }
+                }
+            }
+            NativeNaturalType end = at+1;
+            for(; end < n; ++end) {
+                KeyType nextKey = runKey(end);
+                assert(key < nextKey);
+                if(bounded && nextKey >= bound)
+                    break;
+                key = nextKey;
+            }
+            inserted += end-at;
+            insert(iter, end-at, [&](Page* page, OffsetType index, OffsetType endIndex) {
+                for(; index < endIndex; ++index)
+                    runElement(page, index, at++);
+            });
+            assert(at == end);
+        }
+        return inserted;
     }
 
     struct EraseData {
@@ -359,7 +524,7 @@ struct BpTree {
         LayerType layer;
         Iterator<true> &from, &to, iter;
         OffsetType outerParentIndex[2];
-        Page* outerParent[2];
+        Page *outerParent[2], *changedPages[4];
         RankType rank[4];
     };
 
@@ -368,6 +533,11 @@ struct BpTree {
             data.outerParent[rankIndex]->setRank(data.outerParentIndex[rankIndex], data.rank[rankIndex]);
     }
 
+    static void eraseUpdateAugmentation(EraseData& data, NativeNaturalType pageIndex, Page* candidate) {
+        if(data.changedPages[pageIndex] && candidate == data.outerParent[pageIndex])
+            candidate->setAugmentation(data.outerParentIndex[pageIndex], data.changedPages[pageIndex]->getIntegratedAugmentation());
+    }
+
     template<bool isLeaf, NativeIntegerType dir>
     static Page* eraseAdvance(EraseData& data, Page*& parent, OffsetType& parentIndex, bool condition) {
         if(!condition)
@@ -383,6 +553,8 @@ struct BpTree {
                     page->setRank(data.outerParentIndex[rankIndex], data.rank[rankIndex]);
                 eraseUpdateRank(data, rankIndex, page);
             }
+            if(augmentBits && !isLeaf)
+                eraseUpdateAugmentation(data, rankIndex, page);
             data.outerParent[rankIndex] = getPage(data.iter[data.layer+1]->pageRef);
             data.outerParentIndex[rankIndex] = data.iter[data.layer+1]->index;
             return page;
@@ -396,11 +568,14 @@ struct BpTree {
             if(lowerInner->header.count > 0)
                 return;
             init();
+            updateStats(0, 0, 0, -1);
         } else if(lowerInner->header.count == 1)
-            rootPageRef = lowerInner->getPageRef(0);
+            __atomic_store_n(&rootPageRef, lowerInner->getPageRef(0), __ATOMIC_RELEASE);
         else if(lowerInner->header.count > 1)
             return;
-        releasePage(data.from[data.layer]->pageRef);
+        if(lowerInner->header.isLocked())
+            lowerInner->header.unlock();
+        releasePage<isLeaf>(data.from[data.layer]->pageRef);
         data.spareLowerInner = false;
         data.eraseHigherInner = true;
         lowerInner = nullptr;
@@ -412,7 +587,8 @@ struct BpTree {
                    higherInnerIndex = data.to[data.layer]->index+data.eraseHigherInner, higherInnerParentIndex;
         Page *lowerInner = getPage(data.from[data.layer]->pageRef), *lowerInnerParent,
              *higherInner = getPage(data.to[data.layer]->pageRef), *higherInnerParent;
-        bool keepRunning = true, ranksFromBelow = rankBits && !isLeaf;
+        PageRefType lowerLeafPageRef = lowerInner->header.lowerLeafPageRef, higherLeafPageRef = higherInner->header.higherLeafPageRef;
+        bool keepRunning = true, ranksFromBelow = rankBits && !isLeaf, augmentationFromBelow = augmentBits && !isLeaf;
         if(ranksFromBelow) {
             lowerInner->decumulateRanks(0, lowerInner->header.count);
             if(lowerInner != higherInner)
@@ -424,6 +600,15 @@ struct BpTree {
             if(data.rank[3])
                 higherInner->setRank(data.to[data.layer]->index, data.rank[3]);
         }
+        if(augmentationFromBelow) {
+            eraseUpdateAugmentation(data, 0, lowerInner);
+            eraseUpdateAugmentation(data, 1, higherInner);
+            if(data.changedPages[2])
+                lowerInner->setAugmentation(data.from[data.layer]->index, data.changedPages[2]->getIntegratedAugmentation());
+            if(data.changedPages[3])
+                higherInner->setAugmentation(data.to[data.layer]->index, data.changedPages[3]->getIntegratedAugmentation());
+        }
+        NativeIntegerType elementCount = (isLeaf) ? lowerInner->header.count+((lowerInner != higherInner) ? higherInner->header.count : 0) : 0;
         data.spareLowerInner = true;
         data.eraseHigherInner = false;
         data.from.getParentFrame(data.layer, lowerInnerParent, lowerInnerParentIndex);
@@ -441,27 +626,32 @@ struct BpTree {
             data.to.getParentFrame(data.layer, higherInnerParent, higherInnerParentIndex);
             if(Page::template erase2<isLeaf>(lowerInnerParent, higherInnerParent, lowerInner, higherInner,
                                              lowerInnerParentIndex, higherInnerParentIndex, lowerInnerIndex, higherInnerIndex)) {
-                releasePage(data.to[data.layer]->pageRef);
+                releasePage<isLeaf>(data.to[data.layer]->pageRef);
                 data.eraseHigherInner = true;
                 higherInner = nullptr;
             }
             data.iter.copy(data.to);
             while(data.iter.template advance<-1>(data.layer+1) == 0 &&
-                  data.iter[data.layer]->pageRef != data.from[data.layer]->pageRef)
-                releasePage(data.iter[data.layer]->pageRef);
+                  data.iter[data.layer]->pageRef != data.from[data.layer]->pageRef) {
+                if(isLeaf)
+                    elementCount += getPage(data.iter[data.layer]->pageRef)->header.count;
+                releasePage<isLeaf>(data.iter[data.layer]->pageRef);
+            }
         }
+        if(isLeaf)
+            updateStats(0, 0, ((lowerInner) ? lowerInner->header.count : 0)+((higherInner) ? higherInner->header.count : 0)-elementCount, 0);
         OffsetType lowerInnerKeyParentIndex, higherOuterKeyParentIndex;
         Page *lowerInnerKeyParent, *higherOuterKeyParent, *lowerOuter, *higherOuter;
         bool redistribution = keepRunning && lowerInner->header.count < Page::template capacity<isLeaf>()/2;
-        lowerOuter = eraseAdvance<isLeaf, -1>(data, lowerInnerKeyParent, lowerInnerKeyParentIndex, redistribution || (ranksFromBelow && data.rank[0]));
-        higherOuter = eraseAdvance<isLeaf, 1>(data, higherOuterKeyParent, higherOuterKeyParentIndex, redistribution || (ranksFromBelow && data.rank[1]));
+        lowerOuter = eraseAdvance<isLeaf, -1>(data, lowerInnerKeyParent, lowerInnerKeyParentIndex, redistribution || (ranksFromBelow && data.rank[0]) || (augmentationFromBelow && data.changedPages[0]));
+        higherOuter = eraseAdvance<isLeaf, 1>(data, higherOuterKeyParent, higherOuterKeyParentIndex, redistribution || (ranksFromBelow && data.rank[1]) || (augmentationFromBelow && data.changedPages[1]));
         if(redistribution) {
             if(lowerOuter || higherOuter) {
                 if(lowerInner->header.count == 0 ||
                    Page::template redistribute<isLeaf>(lowerInnerKeyParent, higherOuterKeyParent,
                                                        lowerOuter, lowerInner, higherOuter,
                                                        lowerInnerKeyParentIndex, higherOuterKeyParentIndex)) {
-                    releasePage(data.from[data.layer]->pageRef);
+                    releasePage<isLeaf>(data.from[data.layer]->pageRef);
                     data.spareLowerInner = false;
                     data.eraseHigherInner = true;
                     lowerInner = nullptr;
@@ -469,25 +659,44 @@ struct BpTree {
             } else
                 eraseEmptyLayer<isLeaf>(data, lowerInner);
         }
+        if(isLeaf) {
+            if(lowerInner) {
+                Page::linkLeaves(lowerLeafPageRef, data.from[data.layer]->pageRef);
+                lowerLeafPageRef = data.from[data.layer]->pageRef;
+            }
+            if(higherInner) {
+                Page::linkLeaves(lowerLeafPageRef, data.to[data.layer]->pageRef);
+                lowerLeafPageRef = data.to[data.layer]->pageRef;
+            }
+            Page::linkLeaves(lowerLeafPageRef, higherLeafPageRef);
+        }
         ++data.layer;
-        if(!rankBits)
+        if(!rankBits && !augmentBits)
             return keepRunning;
         Page* pages[] = {lowerOuter, higherOuter, lowerInner, higherInner};
-        for(NativeNaturalType rankIndex = 0; rankIndex < 4; ++rankIndex)
+        for(NativeNaturalType rankIndex = 0; rankIndex < 4; ++rankIndex) {
+            data.changedPages[rankIndex] = pages[rankIndex];
+            if(!rankBits)
+                continue;
             if(pages[rankIndex]) {
                 if(!isLeaf)
                     pages[rankIndex]->cumulateRanks(0, pages[rankIndex]->header.count);
                 data.rank[rankIndex] = pages[rankIndex]->getIntegratedRank();
             } else
                 data.rank[rankIndex] = static_cast<RankType>(0);
+        }
         return data.layer < data.from.end;
     }
 
     void erase(Iterator<true>& from, Iterator<true>& to) {
         assert(!isEmpty() && from.isValid() && to.isValid() && from.compare(to) < 1);
+        PageRefType lockedRootPageRef = rootPageRef;
+        getPage(lockedRootPageRef)->header.lock();
         EraseData data = {false, true, static_cast<LayerType>(0), from, to};
         if(eraseLayer<true>(data))
             while(eraseLayer<false>(data));
+        if(rootPageRef == lockedRootPageRef)
+            getPage(lockedRootPageRef)->header.unlock();
     }
 
     void erase(Iterator<true>& iter) {
@@ -504,6 +713,37 @@ struct BpTree {
         erase(from, to);
     }
 
+    static PageRefType copyPages(PageRefType pageRef, PageRefType& lowerLeafPageRef, NativeNaturalType& elementCount) {
+        bool isLeaf = (getPage(pageRef)->header.layer == 0);
+        PageRefType copyPageRef = (isLeaf) ? acquirePage<true>() : acquirePage<false>();
+        Page* page = getPage(copyPageRef);
+        NativeNaturalType version = page->header.transaction;
+        memcpy(page, getPage(pageRef), bitsPerPage/8);
+        // A recycled page keeps counting up, optimistic readers which still hold it from its previous use must fail to validate
+        page->header.transaction = version+2;
+        if(isLeaf) {
+            Page::linkLeaves(lowerLeafPageRef, copyPageRef);
+            lowerLeafPageRef = copyPageRef;
+            elementCount += page->header.count;
+        } else
+            for(OffsetType index = 0; index < page->header.count; ++index) {
+                PageRefType childPageRef = copyPages(page->getPageRef(index), lowerLeafPageRef, elementCount);
+                page = getPage(copyPageRef);
+                page->setPageRef(index, childPageRef);
+            }
+        return copyPageRef;
+    }
+
+    void copy(BpTree& dst) {
+        assert(dst.isEmpty());
+        if(isEmpty())
+            return;
+        PageRefType lowerLeafPageRef = 0;
+        NativeNaturalType elementCount = 0;
+        dst.rootPageRef = copyPages(rootPageRef, lowerLeafPageRef, elementCount);
+        updateStats(0, 0, elementCount, 1);
+    }
+
     template<FindMode mode>
     bool erase(typename conditional<mode == Rank, RankType, KeyType>::type keyOrRank = 0) {
         Iterator<true> iter;
@@ -512,4 +752,236 @@ struct BpTree {
         erase(iter);
         return true;
     }
+
+    static void spliceIntegrate(Page* page, OffsetType index) {
+        Page* child = getPage(page->getPageRef(index));
+        page->setRank(index, child->getIntegratedRank());
+        if(augmentBits)
+            page->setAugmentation(index, child->getIntegratedAugmentation());
+    }
+
+    template<NativeIntegerType dir>
+    static PageRefType getEdgeLeaf(PageRefType pageRef) {
+        Page* page = getPage(pageRef);
+        while(page->header.layer > 0) {
+            pageRef = page->getPageRef((dir == 1) ? page->header.count-1 : 0);
+            page = getPage(pageRef);
+        }
+        return pageRef;
+    }
+
+    template<bool isLeaf, NativeIntegerType dir>
+    static bool joinLayer(Page* page, Page* innerRoot) {
+        Page *lower = (dir == 1) ? page : innerRoot, *higher = (dir == 1) ? innerRoot : page;
+        OffsetType lowerCount = lower->header.count, higherCount = higher->header.count;
+        if(!isLeaf) {
+            lower->decumulateRanks(0, lowerCount);
+            higher->decumulateRanks(0, higherCount);
+        }
+        bool merge = lowerCount+higherCount <= Page::template capacity<isLeaf>();
+        if(merge) {
+            if(dir == 1)
+                Page::template evacuateDown<isLeaf>(nullptr, lower, higher, 0);
+            else
+                Page::template evacuateUp<isLeaf>(nullptr, lower, higher, 0);
+        } else if(lowerCount < higherCount && lowerCount < Page::template capacity<isLeaf>()/2)
+            Page::template shiftDown<isLeaf>(nullptr, lower, higher, 0, (higherCount-lowerCount)/2);
+        else if(higherCount < lowerCount && higherCount < Page::template capacity<isLeaf>()/2)
+            Page::template shiftUp<isLeaf>(nullptr, lower, higher, 0, (lowerCount-higherCount)/2);
+        if(!isLeaf) {
+            page->cumulateRanks(0, page->header.count);
+            if(!merge)
+                innerRoot->cumulateRanks(0, innerRoot->header.count);
+        }
+        return merge;
+    }
+
+    template<NativeIntegerType dir>
+    static PageRefType join(PageRefType outerRootPageRef, PageRefType innerRootPageRef, PageRefType& lockedPageRef) {
+        Page *outerRoot = getPage(outerRootPageRef), *innerRoot = getPage(innerRootPageRef);
+        LayerType layer = innerRoot->header.layer, outerLayerCount = outerRoot->header.layer+1;
+        PageRefType spine[maxLayerCount];
+        spine[outerLayerCount-1] = outerRootPageRef;
+        for(LayerType i = outerLayerCount-1; i > layer; --i) {
+            Page* page = getPage(spine[i]);
+            spine[i-1] = page->getPageRef((dir == 1) ? page->header.count-1 : 0);
+        }
+        if(dir == 1)
+            Page::linkLeaves(getEdgeLeaf<1>(outerRootPageRef), getEdgeLeaf<-1>(innerRootPageRef));
+        else
+            Page::linkLeaves(getEdgeLeaf<1>(innerRootPageRef), getEdgeLeaf<-1>(outerRootPageRef));
+        Page* page = getPage(spine[layer]);
+        PageRefType carryPageRef = innerRootPageRef;
+        if((layer == 0) ? joinLayer<true, dir>(page, innerRoot) : joinLayer<false, dir>(page, innerRoot)) {
+            if(layer == 0 && dir == 1)
+                Page::linkLeaves(spine[0], innerRoot->header.higherLeafPageRef);
+            else if(layer == 0)
+                Page::linkLeaves(innerRoot->header.lowerLeafPageRef, spine[0]);
+            if(innerRootPageRef == lockedPageRef) {
+                innerRoot->header.unlock();
+                lockedPageRef = 0;
+            }
+            if(layer == 0)
+                releasePage<true>(innerRootPageRef);
+            else
+                releasePage<false>(innerRootPageRef);
+            carryPageRef = 0;
+        }
+        while(++layer < outerLayerCount) {
+            page = getPage(spine[layer]);
+            OffsetType count = page->header.count;
+            page->decumulateRanks(0, count);
+            spliceIntegrate(page, (dir == 1) ? count-1 : 0);
+            if(carryPageRef) {
+                PageRefType higherBranchPageRef = 0;
+                Page* carryPage = page;
+                if(count == Page::template capacity<false>()) {
+                    higherBranchPageRef = acquirePage<false>();
+                    carryPage = getPage(higherBranchPageRef);
+                    carryPage->header.layer = layer;
+                    OffsetType half = count/2;
+                    if(dir == 1) {
+                        Page::template copyBranchElements<false>(carryPage, page, 0, half, count-half);
+                        carryPage->header.count = count-half;
+                        page->header.count = half;
+                    } else {
+                        Page::template copyBranchElements<false>(carryPage, page, 1, 0, half);
+                        Page::template copyBranchElements<false, -1>(page, page, 0, half, count-half);
+                        carryPage->header.count = half;
+                        page->header.count = count-half;
+                    }
+                } else if(dir == -1)
+                    Page::template copyBranchElements<false, 1>(page, page, 1, 0, count);
+                OffsetType carryIndex = (dir == 1) ? carryPage->header.count : 0;
+                ++carryPage->header.count;
+                carryPage->setPageRef(carryIndex, carryPageRef);
+                spliceIntegrate(carryPage, carryIndex);
+                if(higherBranchPageRef)
+                    carryPage->cumulateRanks(0, carryPage->header.count);
+                carryPageRef = higherBranchPageRef;
+            }
+            page->cumulateRanks(0, page->header.count);
+        }
+        if(!carryPageRef)
+            return outerRootPageRef;
+        PageRefType rootPageRef = acquirePage<false>();
+        page = getPage(rootPageRef);
+        page->header.layer = outerLayerCount;
+        page->header.count = 2;
+        page->setPageRef((dir == 1) ? 0 : 1, outerRootPageRef);
+        page->setPageRef((dir == 1) ? 1 : 0, carryPageRef);
+        spliceIntegrate(page, 0);
+        spliceIntegrate(page, 1);
+        page->cumulateRanks(0, 2);
+        return rootPageRef;
+    }
+
+    static PageRefType joinRoots(PageRefType lowerRootPageRef, PageRefType higherRootPageRef, PageRefType& lockedPageRef) {
+        if(!lowerRootPageRef)
+            return higherRootPageRef;
+        if(!higherRootPageRef)
+            return lowerRootPageRef;
+        return (getPage(lowerRootPageRef)->header.layer >= getPage(higherRootPageRef)->header.layer)
+            ? join<1>(lowerRootPageRef, higherRootPageRef, lockedPageRef)
+            : join<-1>(higherRootPageRef, lowerRootPageRef, lockedPageRef);
+    }
+
+    void split(BpTree& higher, RankType rank) {
+        static_assert(rankBits && !keyBits);
+        assert(higher.isEmpty() && rank <= getElementCount());
+        if(rank == getElementCount())
+            return;
+        if(rank == 0) {
+            higher.rootPageRef = rootPageRef;
+            init();
+            return;
+        }
+        PageRefType lockedPageRef = rootPageRef, lowerPageRef = 0, higherPageRef = 0;
+        getPage(lockedPageRef)->header.lock();
+        Iterator<true> iter;
+        find<Rank>(iter, rank);
+        for(LayerType layer = 0; layer < iter.end; ++layer) {
+            auto frame = iter[layer];
+            Page* page = getPage(frame->pageRef);
+            OffsetType count = page->header.count, index = frame->index;
+            if(layer == 0) {
+                PageRefType lowerLeafPageRef = (index > 0) ? frame->pageRef : page->header.lowerLeafPageRef,
+                            higherLeafPageRef = (index < count) ? frame->pageRef : page->header.higherLeafPageRef;
+                if(index > 0 && index < count) {
+                    higherLeafPageRef = acquirePage<true>();
+                    Page* higherPage = getPage(higherLeafPageRef);
+                    higherPage->header.layer = 0;
+                    higherPage->header.count = count-index;
+                    Page::copyLeafElements(higherPage, page, 0, index, count-index);
+                    page->header.count = index;
+                    Page::linkLeaves(higherLeafPageRef, page->header.higherLeafPageRef);
+                }
+                Page::linkLeaves(lowerLeafPageRef, 0);
+                Page::linkLeaves(0, higherLeafPageRef);
+                lowerPageRef = (index > 0) ? frame->pageRef : 0;
+                higherPageRef = (index < count) ? higherLeafPageRef : 0;
+                continue;
+            }
+            OffsetType higherCount = count-index-1;
+            PageRefType lowerBranchPageRef = (index == 1) ? page->getPageRef(0) : 0,
+                        higherBranchPageRef = (higherCount == 1) ? page->getPageRef(index+1) : 0;
+            page->decumulateRanks(0, count);
+            if(higherCount > 1) {
+                if(index > 1) {
+                    higherBranchPageRef = acquirePage<false>();
+                    Page* higherPage = getPage(higherBranchPageRef);
+                    higherPage->header.layer = layer;
+                    higherPage->header.count = higherCount;
+                    Page::template copyBranchElements<false>(higherPage, page, 0, index+1, higherCount);
+                    higherPage->cumulateRanks(0, higherCount);
+                } else {
+                    Page::template copyBranchElements<false, -1>(page, page, 0, index+1, higherCount);
+                    page->header.count = higherCount;
+                    higherBranchPageRef = frame->pageRef;
+                }
+            }
+            if(index > 1) {
+                page->header.count = index;
+                lowerBranchPageRef = frame->pageRef;
+            }
+            if(lowerBranchPageRef == frame->pageRef || higherBranchPageRef == frame->pageRef)
+                page->cumulateRanks(0, page->header.count);
+            else {
+                if(frame->pageRef == lockedPageRef) {
+                    page->header.unlock();
+                    lockedPageRef = 0;
+                }
+                releasePage<false>(frame->pageRef);
+            }
+            lowerPageRef = joinRoots(lowerBranchPageRef, lowerPageRef, lockedPageRef);
+            higherPageRef = joinRoots(higherPageRef, higherBranchPageRef, lockedPageRef);
+        }
+        __atomic_store_n(&rootPageRef, lowerPageRef, __ATOMIC_RELEASE);
+        higher.rootPageRef = higherPageRef;
+        if(lockedPageRef)
+            getPage(lockedPageRef)->header.unlock();
+        updateStats(0, 0, 0, 1);
+    }
+
+    void join(BpTree& higher) {
+        static_assert(rankBits && !keyBits);
+        if(higher.isEmpty())
+            return;
+        if(isEmpty()) {
+            rootPageRef = higher.rootPageRef;
+            higher.init();
+            return;
+        }
+        bool lowerIsOuter = getPage(rootPageRef)->header.layer >= getPage(higher.rootPageRef)->header.layer;
+        PageRefType outerRootPageRef = (lowerIsOuter) ? rootPageRef : higher.rootPageRef,
+                    lockedPageRef = (lowerIsOuter) ? higher.rootPageRef : rootPageRef;
+        getPage(outerRootPageRef)->header.lock();
+        getPage(lockedPageRef)->header.lock();
+        __atomic_store_n(&rootPageRef, joinRoots(rootPageRef, higher.rootPageRef, lockedPageRef), __ATOMIC_RELEASE);
+        higher.init();
+        updateStats(0, 0, 0, -1);
+        if(lockedPageRef)
+            getPage(lockedPageRef)->header.unlock();
+        getPage(outerRootPageRef)->header.unlock();
+    }
 };
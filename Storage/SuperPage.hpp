@@ -10,19 +10,81 @@ const NativeNaturalType bitVectorBucketType[] = {8, 16, 32, 64, 128, 320, 576, 1
 const char* gitRef = "git:" macroToString(GIT_REF);
 
 struct SymbolSpaceState {
+    typedef BpTreeMap<Symbol, NativeNaturalType, NoAugmentation, 100, BitVectorIndexStats> BitVectorIndex;
     Symbol symbolsEnd;
     NativeNaturalType bitVectorCount;
     BpTreeSet<Symbol> recyclableSymbols;
-    BpTreeMap<Symbol, NativeNaturalType> bitVectors;
+    BitVectorIndex bitVectors;
+};
+
+NativeNaturalType addressCacheHits = 0, addressCacheMisses = 0;
+
+double getAddressCacheHitRate() {
+    NativeNaturalType hits = __atomic_load_n(&addressCacheHits, __ATOMIC_RELAXED),
+                      misses = __atomic_load_n(&addressCacheMisses, __ATOMIC_RELAXED);
+    return 100.0*hits/max(hits+misses, static_cast<NativeNaturalType>(1));
+}
+
+// Each entry is a seqlock like the pages, an odd version marks an entry which is being written
+struct AddressCacheEntry {
+    NativeNaturalType version;
+    Symbol symbol;
+    NativeNaturalType address;
 };
 
 struct SymbolSpace {
+    static const NativeNaturalType addressCacheSize = 64;
     Symbol spaceSymbol;
     SymbolSpaceState state;
+    NativeNaturalType addressCacheEpoch;
+    AddressCacheEntry addressCache[addressCacheSize];
 
     SymbolSpace() {}
     SymbolSpace(Symbol _spaceSymbol);
 
+    bool readAddressCache(Symbol symbol, NativeNaturalType& address) {
+        auto& entry = addressCache[symbol%addressCacheSize];
+        NativeNaturalType version = __atomic_load_n(&entry.version, __ATOMIC_ACQUIRE);
+        if(version&1)
+            return false;
+        bool hit = __atomic_load_n(&entry.symbol, __ATOMIC_RELAXED) == symbol;
+        address = __atomic_load_n(&entry.address, __ATOMIC_RELAXED);
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        return hit && __atomic_load_n(&entry.version, __ATOMIC_RELAXED) == version;
+    }
+
+    NativeNaturalType getAddressCacheEpoch() {
+        return __atomic_load_n(&addressCacheEpoch, __ATOMIC_SEQ_CST);
+    }
+
+    // Readers pass the epoch they saw before looking the address up and skip the entry if it is busy,
+    // or if the writer changed any address since, because their address could be outdated already
+    void fillAddressCache(Symbol symbol, NativeNaturalType address, NativeNaturalType epoch) {
+        auto& entry = addressCache[symbol%addressCacheSize];
+        NativeNaturalType version = __atomic_load_n(&entry.version, __ATOMIC_RELAXED);
+        if((version&1) || !__atomic_compare_exchange_n(&entry.version, &version, version+1, false, __ATOMIC_SEQ_CST, __ATOMIC_RELAXED))
+            return;
+        __atomic_thread_fence(__ATOMIC_RELEASE);
+        if(getAddressCacheEpoch() == epoch) {
+            __atomic_store_n(&entry.symbol, symbol, __ATOMIC_RELAXED);
+            __atomic_store_n(&entry.address, address, __ATOMIC_RELAXED);
+        }
+        __atomic_store_n(&entry.version, version+2, __ATOMIC_RELEASE);
+    }
+
+    // The writer has to overwrite the entry after changing the index, so it waits for readers filling it
+    void updateAddressCache(Symbol symbol, NativeNaturalType address) {
+        __atomic_fetch_add(&addressCacheEpoch, 1, __ATOMIC_SEQ_CST);
+        auto& entry = addressCache[symbol%addressCacheSize];
+        NativeNaturalType version = __atomic_load_n(&entry.version, __ATOMIC_RELAXED);
+        while((version&1) || !__atomic_compare_exchange_n(&entry.version, &version, version+1, false, __ATOMIC_SEQ_CST, __ATOMIC_RELAXED))
+            version = __atomic_load_n(&entry.version, __ATOMIC_RELAXED);
+        __atomic_thread_fence(__ATOMIC_RELEASE);
+        __atomic_store_n(&entry.symbol, symbol, __ATOMIC_RELAXED);
+        __atomic_store_n(&entry.address, address, __ATOMIC_RELAXED);
+        __atomic_store_n(&entry.version, version+2, __ATOMIC_RELEASE);
+    }
+
     void updateState();
 
     void iterateSymbols(Closure<void(Symbol)> callback) {
@@ -51,16 +113,23 @@ struct SymbolSpace {
 struct SuperPage : public BasePage {
     Natural64 version;
     Natural8 gitRef[44], architectureSizeLog2;
-    PageRefType pagesEnd, recyclablePage;
+    PageRefType pagesEnd, recyclablePage, recyclablePageCount;
     BpTreeSet<PageRefType> fullBitVectorBuckets, freeBitVectorBuckets[bitVectorBucketTypeCount];
     BpTreeMap<Symbol, SymbolSpaceState> symbolSpaces;
+    BpTreeMap<PageRefType, NativeNaturalType> sharedBitVectors;
+    Stats stats[StatsCategoryCount];
 
     void init(bool resetPagesEnd) {
         version = 0;
         memcpy(gitRef, ::gitRef, sizeof(gitRef));
         architectureSizeLog2 = BitMask<NativeNaturalType>::ceilLog2(architectureSize);
-        if(resetPagesEnd)
+        if(resetPagesEnd) {
             pagesEnd = minPageCount;
+            recyclablePageCount = 0;
+            memset(stats, 0, sizeof(stats));
+            stats[MetaStructsStats].totalMetaData = bitsPerPage;
+            stats[MetaStructsStats].inhabitedMetaData = sizeOfInBits<SuperPage>::value;
+        }
         heapSymbolSpace = SymbolSpace(0);
     }
 } *superPage;
@@ -77,12 +146,17 @@ PageRefType referenceOfPage(void* page) {
     return pageRef;
 }
 
+PageRefType getPagesEnd() {
+    return __atomic_load_n(&superPage->pagesEnd, __ATOMIC_RELAXED);
+}
+
 PageRefType acquirePage() {
     assert(superPage);
     if(superPage->recyclablePage) {
         PageRefType pageRef = superPage->recyclablePage;
         auto recyclablePage = dereferencePage<RecyclablePage>(pageRef);
         superPage->recyclablePage = recyclablePage->next;
+        --superPage->recyclablePageCount;
         return pageRef;
     } else {
         resizeMemory(superPage->pagesEnd+1);
@@ -99,9 +173,14 @@ void releasePage(PageRefType pageRef) {
         auto recyclablePage = dereferencePage<RecyclablePage>(pageRef);
         recyclablePage->next = superPage->recyclablePage;
         superPage->recyclablePage = pageRef;
+        ++superPage->recyclablePageCount;
     }
 }
 
+Stats& getStats(NativeNaturalType category) {
+    return superPage->stats[category];
+}
+
 NativeNaturalType countRecyclablePages() {
     auto superPage = dereferencePage<SuperPage>(0);
     if(!superPage->recyclablePage)
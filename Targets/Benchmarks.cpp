@@ -0,0 +1,203 @@
+#include <Targets/POSIX.hpp>
+#include <pthread.h>
+#include <time.h>
+
+extern "C" {
+
+const NativeNaturalType elementCount = 1024*1024, lookupsPerThread = 1024*1024*4, valueMask = BitMask<NativeNaturalType>::fillLSBs(40);
+const NativeNaturalType contentSymbolCount = 16, contentBits = 1024*256;
+BpTreeMap<NativeNaturalType, NativeNaturalType> map;
+Symbol contentSymbols[contentSymbolCount];
+volatile bool writerRunning;
+
+void assertFailed(const char* message) {
+    printf("Assertion failed in %s\n", message);
+    abort();
+}
+
+double getTime() {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec+now.tv_nsec*1.0e-9;
+}
+
+NativeNaturalType nextRandom(NativeNaturalType& state) {
+    state ^= state<<13;
+    state ^= state>>7;
+    state ^= state<<17;
+    return state;
+}
+
+void* readerThread(void* argument) {
+    NativeNaturalType state = reinterpret_cast<NativeNaturalType>(argument)*0x9E3779B97F4A7C15ULL+1;
+    for(NativeNaturalType i = 0; i < lookupsPerThread; ++i) {
+        NativeNaturalType key = (nextRandom(state)%elementCount)*2, value;
+        assert(map.findValue(key, value) && (value&valueMask) == key);
+    }
+    return nullptr;
+}
+
+void* writerThread(void* argument) {
+    NativeNaturalType state = 1, round = 0;
+    while(writerRunning) {
+        NativeNaturalType key = (nextRandom(state)%elementCount)*2;
+        BpTreeMap<NativeNaturalType, NativeNaturalType>::Iterator<true> iter;
+        assert(map.find<Key>(iter, key));
+        iter.setValue(key|(++round<<40));
+        if(round%16 == 0) {
+            assert(map.insert(key+1, key+1));
+            assert(map.erase<Key>(key+1));
+        }
+    }
+    return nullptr;
+}
+
+void benchmarkReaders(NativeNaturalType threadCount, bool withWriter, double& baseline) {
+    pthread_t readers[threadCount], writer;
+    writerRunning = true;
+    if(withWriter)
+        assert(pthread_create(&writer, nullptr, writerThread, nullptr) == 0);
+    double begin = getTime();
+    for(NativeNaturalType i = 0; i < threadCount; ++i)
+        assert(pthread_create(&readers[i], nullptr, readerThread, reinterpret_cast<void*>(i)) == 0);
+    for(NativeNaturalType i = 0; i < threadCount; ++i)
+        assert(pthread_join(readers[i], nullptr) == 0);
+    double seconds = getTime()-begin, throughput = threadCount*lookupsPerThread/seconds*1.0e-6;
+    writerRunning = false;
+    if(withWriter)
+        assert(pthread_join(writer, nullptr) == 0);
+    if(threadCount == 1)
+        baseline = throughput;
+    printf("%3" PrintFormatNatural " readers%s %8.2f M lookups/s %5.2fx\n", threadCount, (withWriter) ? " + writer" : "         ", throughput, throughput/baseline);
+}
+
+void* contentReaderThread(void* argument) {
+    NativeNaturalType state = reinterpret_cast<NativeNaturalType>(argument)*0x9E3779B97F4A7C15ULL+1;
+    for(NativeNaturalType i = 0; i < lookupsPerThread/16; ++i) {
+        BitVector bitVector(BitVectorLocation(&heapSymbolSpace, contentSymbols[nextRandom(state)%contentSymbolCount]));
+        NativeNaturalType offset = (nextRandom(state)%(contentBits/architectureSize))*architectureSize, value;
+        assert(bitVector.externalOperate<false>(&value, offset, architectureSize) && (value&valueMask) == offset);
+    }
+    return nullptr;
+}
+
+// Overwrites the content the readers check and keeps inserting into and erasing from the BitVector index
+void* contentWriterThread(void* argument) {
+    NativeNaturalType state = 1, round = 0;
+    while(writerRunning) {
+        BitVector bitVector(BitVectorLocation(&heapSymbolSpace, contentSymbols[nextRandom(state)%contentSymbolCount]));
+        NativeNaturalType offset = (nextRandom(state)%(contentBits/architectureSize))*architectureSize, value = offset|(++round<<40);
+        assert(bitVector.externalOperate<true>(&value, offset, architectureSize));
+        if(round%16 == 0) {
+            BitVectorGuard<BitVector> temporary;
+            temporary.setSize(architectureSize*4);
+        }
+    }
+    return nullptr;
+}
+
+void benchmarkContentReaders(NativeNaturalType threadCount, bool withWriter) {
+    pthread_t readers[threadCount], writer;
+    writerRunning = true;
+    if(withWriter)
+        assert(pthread_create(&writer, nullptr, contentWriterThread, nullptr) == 0);
+    double begin = getTime();
+    for(NativeNaturalType i = 0; i < threadCount; ++i)
+        assert(pthread_create(&readers[i], nullptr, contentReaderThread, reinterpret_cast<void*>(i)) == 0);
+    for(NativeNaturalType i = 0; i < threadCount; ++i)
+        assert(pthread_join(readers[i], nullptr) == 0);
+    double seconds = getTime()-begin;
+    writerRunning = false;
+    if(withWriter)
+        assert(pthread_join(writer, nullptr) == 0);
+    printf("%3" PrintFormatNatural " readers%s %8.2f M BitVector reads/s\n", threadCount, (withWriter) ? " + writer" : "         ", threadCount*lookupsPerThread/16/seconds*1.0e-6);
+}
+
+void benchmarkContent() {
+    for(NativeNaturalType i = 0; i < contentSymbolCount; ++i) {
+        contentSymbols[i] = heapSymbolSpace.createSymbol();
+        BitVector bitVector(BitVectorLocation(&heapSymbolSpace, contentSymbols[i]));
+        bitVector.setSize(contentBits);
+        for(NativeNaturalType offset = 0; offset < contentBits; offset += architectureSize)
+            bitVector.externalOperate<true>(&offset, offset, architectureSize);
+    }
+    NativeNaturalType maxThreadCount = sysconf(_SC_NPROCESSORS_ONLN);
+    benchmarkContentReaders(maxThreadCount, false);
+    benchmarkContentReaders(maxThreadCount, true);
+    for(NativeNaturalType i = 0; i < contentSymbolCount; ++i)
+        heapSymbolSpace.releaseSymbol(contentSymbols[i]);
+}
+
+void benchmarkScaling(bool withWriter) {
+    NativeNaturalType maxThreadCount = sysconf(_SC_NPROCESSORS_ONLN);
+    double baseline;
+    for(NativeNaturalType threadCount = 1; ; threadCount = min(threadCount*2, maxThreadCount)) {
+        benchmarkReaders(threadCount, withWriter, baseline);
+        if(threadCount == maxThreadCount)
+            break;
+    }
+}
+
+void benchmarkMetaVector(NativeNaturalType elementCount, NativeNaturalType childLength) {
+    const NativeNaturalType moveCount = 1024*4;
+    BitVectorGuard<DataStructure<MetaVector<NativeNaturalType>>> metaVector;
+    for(NativeNaturalType at = 0; at < elementCount; ++at) {
+        metaVector.insertElementAt(at, at);
+        metaVector.increaseSize(metaVector.getChildOffset(at), childLength, at);
+    }
+    NativeNaturalType state = 1;
+    double begin = getTime();
+    for(NativeNaturalType i = 0; i < moveCount; ++i)
+        metaVector.moveElementAt(nextRandom(state)%elementCount, nextRandom(state)%elementCount);
+    printf("MetaVector %5" PrintFormatNatural " x %4" PrintFormatNatural " bits %8.2f us/move\n", elementCount, childLength, (getTime()-begin)*1.0e6/moveCount);
+}
+
+}
+
+template<bool fenwickTree>
+void benchmarkPairSet(NativeNaturalType firstKeyCount) {
+    const NativeNaturalType elementCount = firstKeyCount*4;
+    BitVectorGuard<DataStructure<PairSet<NativeNaturalType, NativeNaturalType, BitVectorContainer, fenwickTree>>> pairSet;
+    NativeNaturalType state = 1, firstAt, secondAt, found = 0;
+    double begin = getTime();
+    for(NativeNaturalType i = 0; i < elementCount; ++i)
+        pairSet.insertElement({nextRandom(state)%firstKeyCount, state>>32});
+    double inserted = getTime();
+    state = 1;
+    for(NativeNaturalType i = 0; i < elementCount; ++i)
+        found += pairSet.findElement({nextRandom(state)%firstKeyCount, state>>32}, firstAt, secondAt);
+    double end = getTime();
+    assert(found == elementCount);
+    printf("PairSet %-7s %5" PrintFormatNatural " x 4 %8.2f us/insert %8.2f us/find\n", (fenwickTree) ? "fenwick" : "flat",
+           firstKeyCount, (inserted-begin)*1.0e6/elementCount, (end-inserted)*1.0e6/elementCount);
+}
+
+extern "C" {
+
+Integer32 main(Integer32 argc, Integer8** argv) {
+    if(argc != 2) {
+        printf("Expected path argument.\n");
+        exit(1);
+    }
+    loadStorage(argv[1]);
+    NativeNaturalType keys[4096];
+    for(NativeNaturalType i = 0; i < elementCount; i += sizeof(keys)/sizeof(NativeNaturalType)) {
+        for(NativeNaturalType j = 0; j < sizeof(keys)/sizeof(NativeNaturalType); ++j)
+            keys[j] = (i+j)*2;
+        map.insertSorted(keys, keys, sizeof(keys)/sizeof(NativeNaturalType));
+    }
+    benchmarkScaling(false);
+    benchmarkScaling(true);
+    map.erase();
+    benchmarkContent();
+    benchmarkMetaVector(64, 64);
+    benchmarkMetaVector(2048, 512);
+    for(NativeNaturalType firstKeyCount = 4; firstKeyCount <= 4096; firstKeyCount *= 8) {
+        benchmarkPairSet<false>(firstKeyCount);
+        benchmarkPairSet<true>(firstKeyCount);
+    }
+    unloadStorage();
+    return 0;
+}
+
+}
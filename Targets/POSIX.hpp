@@ -45,29 +45,41 @@ void printStatsPartial(struct Stats& stats) {
     printStatsLine("      Inhabited   ", stats.inhabitedPayload, stats.totalPayload);
 }
 
-void printStats() {
-    NativeNaturalType bitVectorInBucketTypes[bitVectorBucketTypeCount+1];
+bool equalStats(struct Stats& a, struct Stats& b) {
+    return a.uninhabitable == b.uninhabitable &&
+           a.totalMetaData == b.totalMetaData &&
+           a.inhabitedMetaData == b.inhabitedMetaData &&
+           a.totalPayload == b.totalPayload &&
+           a.inhabitedPayload == b.inhabitedPayload;
+}
+
+void printStats(bool verify = false) {
+    const char* categoryNames[StatsCategoryCount] = {"Meta Structures ", "BitVector Index ", "Full Buckets    ", "Free Buckets    ", "Fragmented      "};
+    NativeNaturalType bitVectorInBucketTypes[bitVectorBucketTypeCount+1], inlineBitVectorCount = 0;
     for(NativeNaturalType i = 0; i < bitVectorBucketTypeCount+1; ++i)
         bitVectorInBucketTypes[i] = 0;
-    struct Stats metaStructs, bitVectorIndex, fullBuckets, freeBuckets, fragmented;
-    resetStats(metaStructs);
-    resetStats(bitVectorIndex);
-    resetStats(fullBuckets);
-    resetStats(freeBuckets);
-    resetStats(fragmented);
+    struct Stats traversed[StatsCategoryCount];
+    for(NativeNaturalType i = 0; i < StatsCategoryCount; ++i)
+        resetStats(traversed[i]);
     printf("Stats:\n");
-    superPage->symbolSpaces.generateStats(metaStructs, [&](BpTreeMap<Symbol, SymbolSpaceState>::Iterator<false> iter) {
-        SymbolSpace symbolSpace(iter.getKey());
-        NativeNaturalType recyclableSymbolCount = 0;
-        symbolSpace.state.recyclableSymbols.generateStats(metaStructs, [&](BpTreeSet<Symbol>::Iterator<false>& iter) {
-            ++recyclableSymbolCount;
-        });
-        symbolSpace.state.bitVectors.generateStats(bitVectorIndex, [&](BpTreeMap<Symbol, NativeNaturalType>::Iterator<false> iter) {
-            BitVector bitVector(BitVectorLocation(&symbolSpace, iter.getKey()));
-            ++bitVectorInBucketTypes[BitVectorBucket::getType(bitVector.getSize())];
-            if(bitVector.state == BitVector::Fragmented)
-                bitVector.bpTree.generateStats(fragmented);
-        });
+    auto printSymbolSpace = [&](Symbol spaceSymbol) {
+        SymbolSpace symbolSpace(spaceSymbol);
+        NativeNaturalType recyclableSymbolCount = symbolSpace.state.symbolsEnd-symbolSpace.state.bitVectorCount;
+        if(verify) {
+            recyclableSymbolCount = 0;
+            symbolSpace.state.recyclableSymbols.generateStats(traversed[MetaStructsStats], [&](BpTreeSet<Symbol>::Iterator<false>& iter) {
+                ++recyclableSymbolCount;
+            });
+            symbolSpace.state.bitVectors.generateStats(traversed[BitVectorIndexStats], [&](SymbolSpaceState::BitVectorIndex::Iterator<false> iter) {
+                BitVector bitVector(BitVectorLocation(&symbolSpace, iter.getKey()));
+                if(bitVector.state == BitVector::Inline)
+                    ++inlineBitVectorCount;
+                else
+                    ++bitVectorInBucketTypes[(bitVector.state == BitVector::InBucket) ? bitVector.bucket->header.type : bitVectorBucketTypeCount];
+                if(bitVector.state == BitVector::Fragmented)
+                    bitVector.bpTree.generateStats(traversed[FragmentedStats]);
+            });
+        }
         printf("SymbolSpace       %10" PrintFormatNatural "\n", symbolSpace.spaceSymbol);
         if(symbolSpace.spaceSymbol > 0)
             printf("  Triples:        %10" PrintFormatNatural "\n", reinterpret_cast<Ontology&>(symbolSpace).query(VVV));
@@ -75,35 +87,60 @@ void printStats() {
         printf("  Recyclable      %10" PrintFormatNatural "\n", recyclableSymbolCount);
         printf("  Empty           %10" PrintFormatNatural "\n", symbolSpace.state.symbolsEnd-symbolSpace.state.bitVectorCount-recyclableSymbolCount);
         printf("  BitVectors      %10" PrintFormatNatural "\n", symbolSpace.state.bitVectorCount);
+        if(!verify)
+            return;
+        printf("    Inline        %10" PrintFormatNatural "\n", inlineBitVectorCount);
         for(NativeNaturalType i = 0; i < bitVectorBucketTypeCount; ++i)
             printf("    %10" PrintFormatNatural "    %10" PrintFormatNatural "\n", bitVectorBucketType[i], bitVectorInBucketTypes[i]);
         printf("    Fragmented    %10" PrintFormatNatural "\n", bitVectorInBucketTypes[bitVectorBucketTypeCount]);
         assert(symbolSpace.state.symbolsEnd-symbolSpace.state.bitVectorCount == recyclableSymbolCount);
-    });
+    };
+    if(verify)
+        superPage->symbolSpaces.generateStats(traversed[MetaStructsStats], [&](BpTreeMap<Symbol, SymbolSpaceState>::Iterator<false> iter) {
+            printSymbolSpace(iter.getKey());
+        });
+    else
+        superPage->symbolSpaces.iterateKeys(printSymbolSpace);
     NativeNaturalType totalBits = superPage->pagesEnd*bitsPerPage,
-                      recyclableBits = countRecyclablePages()*bitsPerPage;
-    metaStructs.totalMetaData += bitsPerPage;
-    metaStructs.inhabitedMetaData += sizeOfInBits<SuperPage>::value;
-    superPage->fullBitVectorBuckets.generateStats(metaStructs, [&](BpTreeSet<PageRefType>::Iterator<false>& iter) {
-        dereferencePage<BitVectorBucket>(iter.getKey())->generateStats(fullBuckets);
-    });
-    for(NativeNaturalType i = 0; i < bitVectorBucketTypeCount; ++i)
-        superPage->freeBitVectorBuckets[i].generateStats(metaStructs, [&](BpTreeSet<PageRefType>::Iterator<false>& iter) {
-            dereferencePage<BitVectorBucket>(iter.getKey())->generateStats(freeBuckets);
+                      recyclableBits = superPage->recyclablePageCount*bitsPerPage,
+                      categoryBits = 0;
+    if(verify) {
+        assert(countRecyclablePages() == superPage->recyclablePageCount);
+        traversed[MetaStructsStats].totalMetaData += bitsPerPage;
+        traversed[MetaStructsStats].inhabitedMetaData += sizeOfInBits<SuperPage>::value;
+        superPage->fullBitVectorBuckets.generateStats(traversed[MetaStructsStats], [&](BpTreeSet<PageRefType>::Iterator<false>& iter) {
+            dereferencePage<BitVectorBucket>(iter.getKey())->generateStats(traversed[FullBucketsStats]);
         });
+        for(NativeNaturalType i = 0; i < bitVectorBucketTypeCount; ++i)
+            superPage->freeBitVectorBuckets[i].generateStats(traversed[MetaStructsStats], [&](BpTreeSet<PageRefType>::Iterator<false>& iter) {
+                dereferencePage<BitVectorBucket>(iter.getKey())->generateStats(traversed[FreeBucketsStats]);
+            });
+        superPage->sharedBitVectors.generateStats(traversed[MetaStructsStats], [&](BpTreeMap<PageRefType, NativeNaturalType>::Iterator<false> iter) {
+            struct Stats shared;
+            resetStats(shared);
+            BpTreeBitVector bpTree;
+            bpTree.rootPageRef = iter.getKey();
+            bpTree.generateStats(shared);
+            Stats& fragmented = traversed[FragmentedStats];
+            fragmented.uninhabitable -= shared.uninhabitable*iter.getValue();
+            fragmented.totalMetaData -= shared.totalMetaData*iter.getValue();
+            fragmented.inhabitedMetaData -= shared.inhabitedMetaData*iter.getValue();
+            fragmented.totalPayload -= shared.totalPayload*iter.getValue();
+            fragmented.inhabitedPayload -= shared.inhabitedPayload*iter.getValue();
+        });
+        for(NativeNaturalType i = 0; i < StatsCategoryCount; ++i)
+            assert(equalStats(traversed[i], superPage->stats[i]));
+    }
     printf("Global            %10" PrintFormatNatural " bits %" PrintFormatNatural " pages\n", totalBits, superPage->pagesEnd);
     printStatsLine("  Recyclable      ", recyclableBits, totalBits);
-    printf("  Meta Structures ");
-    printStatsPartial(metaStructs);
-    printf("  BitVector Index ");
-    printStatsPartial(bitVectorIndex);
-    printf("  Full Buckets    ");
-    printStatsPartial(fullBuckets);
-    printf("  Free Buckets    ");
-    printStatsPartial(freeBuckets);
-    printf("  Fragmented      ");
-    printStatsPartial(fragmented);
-    assert(recyclableBits+metaStructs.total+bitVectorIndex.total+fullBuckets.total+freeBuckets.total+fragmented.total == totalBits);
+    printf("  Address Cache   %10" PrintFormatNatural " hits %2.2f %%\n", addressCacheHits, getAddressCacheHitRate());
+    for(NativeNaturalType i = 0; i < StatsCategoryCount; ++i) {
+        struct Stats stats = superPage->stats[i];
+        printf("  %s", categoryNames[i]);
+        printStatsPartial(stats);
+        categoryBits += stats.total;
+    }
+    assert(recyclableBits+categoryBits == totalBits);
 }
 
 
@@ -116,33 +153,42 @@ void exportOntology(const char* path, Ontology* srcOntology) {
     BinaryOntologyEncoder encoder(bitVector, srcOntology);
     encoder.encode();
     int fd = open(path, O_WRONLY|O_CREAT, 0660);
-    Natural8 buffer[512];
-    for(NativeNaturalType offset = 0, size = encoder.bitVector.getSize(); offset < size; ) {
-        NativeNaturalType sliceLength = min(size-offset, static_cast<NativeNaturalType>(sizeof(buffer)*8));
-        bitVector.externalOperate<false>(buffer, offset, sliceLength);
-        assert(write(fd, buffer, sliceLength/8) > 0);
-        offset += sliceLength;
-    }
+    NativeNaturalType buffer[64], bufferLength = 0;
+    bitVector.iterateSpans(0, bitVector.getSize(), [&](const NativeNaturalType* base, NativeNaturalType offset, NativeNaturalType length) {
+        if(bufferLength == 0 && offset%8 == 0 && length >= 8) {
+            NativeNaturalType directLength = length-length%8;
+            assert(write(fd, reinterpret_cast<const Natural8*>(base)+offset/8, directLength/8) > 0);
+            offset += directLength;
+            length -= directLength;
+        }
+        while(length > 0) {
+            NativeNaturalType sliceLength = min(length, static_cast<NativeNaturalType>(sizeof(buffer)*8-bufferLength));
+            bitwiseCopy<-1>(buffer, base, bufferLength, offset, sliceLength);
+            bufferLength += sliceLength;
+            offset += sliceLength;
+            length -= sliceLength;
+            if(bufferLength == sizeof(buffer)*8) {
+                assert(write(fd, buffer, sizeof(buffer)) > 0);
+                bufferLength = 0;
+            }
+        }
+    });
+    if(bufferLength >= 8)
+        assert(write(fd, buffer, bufferLength/8) > 0);
     close(fd);
 }
 
 void importOntology(const char* path, Ontology* dstOntology) {
-    BitVectorGuard<BitVector> bitVector;
-    BinaryOntologyDecoder decoder(dstOntology, bitVector);
     int fd = open(path, O_RDONLY, 0660);
-    Natural8 buffer[512];
     struct stat fdStat;
     assert(fstat(fd, &fdStat) == 0);
-    NativeNaturalType size = fdStat.st_size*8;
-    decoder.bitVector.setSize(size);
-    for(NativeNaturalType offset = 0; offset < size; ) {
-        NativeNaturalType sliceLength = min(size-offset, static_cast<NativeNaturalType>(sizeof(buffer)*8));
-        assert(read(fd, buffer, sliceLength/8) > 0);
-        bitVector.externalOperate<true>(buffer, offset, sliceLength);
-        offset += sliceLength;
-    }
-    close(fd);
+    void* data = MMAP_FUNC(0, fdStat.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    assert(data != MAP_FAILED);
+    BitVector bitVector(data, fdStat.st_size*8);
+    BinaryOntologyDecoder decoder(dstOntology, bitVector);
     decoder.decode();
+    assert(munmap(data, fdStat.st_size) == 0);
+    close(fd);
 }
 
 NativeNaturalType bytesForPages(NativeNaturalType pagesEnd) {
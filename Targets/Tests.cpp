@@ -162,6 +162,137 @@ Integer32 main(Integer32 argc, Integer8** argv) {
     }
 #endif
 
+    test("BpTreeMap") {
+        const NativeNaturalType elementCount = 4096;
+        NativeNaturalType keys[elementCount], values[elementCount];
+        BpTreeMap<NativeNaturalType, NativeNaturalType> map;
+        map.init();
+        for(NativeNaturalType i = 0; i < elementCount; ++i) {
+            keys[i] = i*4;
+            values[i] = i;
+        }
+        assert(map.insertSorted(keys, values, elementCount) == elementCount);
+        for(NativeNaturalType i = 0; i < elementCount; ++i)
+            keys[i] = i*2;
+        assert(map.insertSorted(keys, values, elementCount) == elementCount/2);
+        NativeNaturalType key = 0;
+        BpTreeMap<NativeNaturalType, NativeNaturalType>::Iterator<false> iter;
+        map.find<First>(iter);
+        do {
+            assert(iter.getKey() == key && iter.getValue() == key/((key%4) ? 2 : 4));
+            key += (key < elementCount*2) ? 2 : 4;
+        } while(iter.advance() == 0);
+        assert(key == elementCount*4);
+        map.find<Last>(iter);
+        do {
+            key -= (key <= elementCount*2) ? 2 : 4;
+            assert(iter.getKey() == key);
+        } while(iter.advance<-1>() == 0);
+        assert(key == 0);
+        NativeNaturalType count = 0;
+        for(NativeNaturalType i = 0; i < elementCount; ++i) {
+            keys[i] = i*3;
+            count += keys[i]%2 == 0 && (keys[i] < elementCount*2 || keys[i]%4 == 0);
+        }
+        map.findValues(keys, elementCount, [&](NativeNaturalType at, NativeNaturalType value) {
+            assert(keys[at]%2 == 0 && (keys[at] < elementCount*2 || keys[at]%4 == 0));
+            assert(value == keys[at]/((keys[at]%4) ? 2 : 4));
+            ++key;
+        });
+        assert(key == count);
+        BpTreeMap<NativeNaturalType, NativeNaturalType>::Iterator<false> finger;
+        map.find<First>(finger);
+        for(NativeNaturalType i = 0; i < 256; ++i) {
+            key = (i*2654435761ULL)%(elementCount*4);
+            assert(map.seek<Key>(finger, key) == map.find<Key>(iter, key));
+            assert(finger[0]->pageRef == iter[0]->pageRef && finger[0]->index == iter[0]->index);
+        }
+        map.find<Key>(iter, 6);
+        assert(iter.validate());
+        BpTreeMap<NativeNaturalType, NativeNaturalType>::Iterator<true> writeIter;
+        map.find<Key>(writeIter, 6);
+        writeIter.setValue(7);
+        assert(!iter.validate() && map.findValue(6, key) && key == 7 && !map.findValue(7, key));
+        map.erase();
+        assert(map.isEmpty());
+        BpTreeMap<NativeNaturalType, NativeNaturalType, NoAugmentation, 75> edgeMap;
+        edgeMap.init();
+        for(NativeNaturalType i = 0; i < elementCount; ++i)
+            assert(edgeMap.insert(elementCount-i, i) && edgeMap.insert(elementCount+1+i, i));
+        BpTreeMap<NativeNaturalType, NativeNaturalType, NoAugmentation, 75>::Iterator<false> edgeIter;
+        edgeMap.find<First>(edgeIter);
+        key = 1;
+        do {
+            assert(edgeIter.getKey() == key && edgeIter.getValue() == ((key > elementCount) ? key-elementCount-1 : elementCount-key));
+            ++key;
+        } while(edgeIter.advance() == 0);
+        assert(key == elementCount*2+1);
+        for(NativeNaturalType i = 0; i < elementCount; ++i)
+            assert(map.insert(elementCount-i, i) && map.insert(elementCount+1+i, i));
+        Stats edgeStats = {}, mapStats = {};
+        edgeMap.generateStats(edgeStats);
+        map.generateStats(mapStats);
+        assert(edgeStats.totalPayload*4 < mapStats.totalPayload*3);
+        map.erase();
+        edgeMap.erase();
+    }
+
+    test("BpTreeAugmentation") {
+        const NativeNaturalType elementCount = 65536;
+        NativeNaturalType values[elementCount], key;
+        BpTreeMap<NativeNaturalType, NativeNaturalType, SumAugmentation<NativeNaturalType>> map;
+        map.init();
+        for(NativeNaturalType i = 0; i < elementCount; ++i) {
+            key = (i*2654435761ULL)%elementCount;
+            values[key] = key;
+            assert(map.insert(key*2, key));
+        }
+        BpTreeMap<NativeNaturalType, NativeNaturalType, SumAugmentation<NativeNaturalType>>::Iterator<true> from, to;
+        map.find<Key>(from, 1000);
+        map.find<Key>(to, 60000);
+        map.erase(from, to);
+        for(NativeNaturalType i = 500; i <= 30000; ++i)
+            values[i] = 0;
+        for(NativeNaturalType i = 0; i < 64; ++i) {
+            key = (i*40503)%elementCount;
+            if(map.find<Key>(from, key*2)) {
+                from.setValue(i);
+                values[key] = i;
+            }
+        }
+        for(NativeNaturalType i = 0; i < 64; ++i) {
+            NativeNaturalType begin = (i*7919)%elementCount, end = begin+(i*104729)%(elementCount-begin), sum = 0;
+            for(NativeNaturalType j = begin; j < end; ++j)
+                sum += values[j];
+            assert(map.aggregate<Key>(begin*2, end*2) == sum);
+        }
+        map.erase();
+
+        BpTree<VoidType, NativeNaturalType, 1, PopCountAugmentation> bits;
+        bits.init();
+        key = 0;
+        decltype(bits)::Iterator<true> iter, end;
+        for(NativeNaturalType chunk = 0; chunk < 64; ++chunk) {
+            bits.find<Rank>(iter, chunk*4096);
+            bits.insert(iter, 4096, [&](decltype(bits)::Page* page, decltype(bits)::OffsetType index, decltype(bits)::OffsetType endIndex) {
+                for(; index < endIndex; ++index) {
+                    NativeNaturalType bit = (key++%3 == 0);
+                    bitwiseCopy<-1>(reinterpret_cast<NativeNaturalType*>(page), &bit, decltype(bits)::Page::valueOffset+index, 0, 1);
+                }
+            });
+        }
+        bits.find<Rank>(iter, 1000);
+        bits.find<Rank>(end, 199999);
+        bits.erase(iter, end);
+        for(NativeNaturalType i = 0; i < 64; ++i) {
+            NativeNaturalType begin = (i*7919)%bits.getElementCount(), end = begin+(i*104729)%(bits.getElementCount()-begin), count = 0;
+            for(NativeNaturalType j = begin; j < end; ++j)
+                count += ((j < 1000) ? j : j+199000)%3 == 0;
+            assert(bits.aggregate<Rank>(begin, end) == count);
+        }
+        bits.erase();
+    }
+
     test("BitVector") {
         BitVectorGuard<BitVector> bitVector, bitVectorB;
         assert(bitVector.getSize() == 0);
@@ -189,6 +320,170 @@ Integer32 main(Integer32 argc, Integer8** argv) {
             && bitVectorB.replaceSlice(bitVectorB, 32, 0, 32)
             && bitVectorB.template externalOperate<false>(&data, 0, 64)
             && data == 0x0011223300112233);
+        bitVectorB.setSize(48);
+        data = 0;
+        assert(BitVector(bitVectorB.location).state == BitVector::Inline
+            && bitVectorB.template externalOperate<false>(&data, 0, 48)
+            && data == 0x223300112233
+            && bitVectorB.increaseSize(16, 16)
+            && BitVector(bitVectorB.location).state == BitVector::InBucket
+            && bitVectorB.decreaseSize(0, 32));
+        data = 0;
+        assert(bitVectorB.template externalOperate<false>(&data, 0, 32)
+            && data == 0x22330011
+            && BitVector(bitVectorB.location).state == BitVector::Inline);
+        BitVector alias(bitVectorB.location);
+        data = 0x6677;
+        assert(alias.externalOperate<true>(&data, 0, 16));
+        data = 0;
+        assert(bitVectorB.externalOperate<false>(&data, 0, 32)
+            && data == 0x22336677);
+        data = 0x0011;
+        assert(alias.externalOperate<true>(&data, 0, 16));
+        assert(bitVectorB.reserve(1000)
+            && bitVectorB.getCapacity() >= 1000
+            && bitVectorB.getSize() == 32);
+        NativeNaturalType address = bitVectorB.address;
+        for(NativeNaturalType i = 0; i < 30; ++i)
+            assert(bitVectorB.increaseSize(0, 32));
+        data = 0;
+        assert(BitVector(bitVectorB.location).address == address
+            && bitVectorB.template externalOperate<false>(&data, 960, 32)
+            && data == 0x22330011
+            && bitVectorB.decreaseSize(0, 400)
+            && BitVector(bitVectorB.location).address == address
+            && bitVectorB.decreaseSize(0, 400)
+            && BitVector(bitVectorB.location).address != address
+            && bitVectorB.getSize() == 192);
+        BitVectorGuard<BitVector> reserved;
+        assert(reserved.reserve(1000)
+            && reserved.state == BitVector::Empty
+            && reserved.getCapacity() >= 1000
+            && reserved.increaseSize(0, 32)
+            && reserved.state == BitVector::InBucket
+            && reserved.getCapacity() >= 1000);
+        bitVectorB.setSize(750*16);
+        for(NativeNaturalType i = 0; i < 750; ++i)
+            assert(bitVectorB.template externalOperate<true>(&i, i*16, 16));
+        assert(BitVector(bitVectorB.location).state == BitVector::InBucket
+            && bitVectorB.moveSlice(450*16, 0, 300*16));
+        for(NativeNaturalType i = 0; i < 750; ++i) {
+            data = 0;
+            assert(bitVectorB.template externalOperate<false>(&data, i*16, 16) && data == (i+300)%750);
+        }
+        BitVectorGuard<BitVector> bucketA, bucketB, bucketC, bucketD, bucketE;
+        bucketA.setSize(8000);
+        bucketB.setSize(8000);
+        bucketC.setSize(8000);
+        bucketD.setSize(8000);
+        bucketA.setSize(0);
+        bucketE.setSize(8000);
+        assert(BitVector(bucketD.location).pageRef != BitVector(bucketB.location).pageRef
+            && BitVector(bucketE.location).pageRef == BitVector(bucketD.location).pageRef);
+        const NativeNaturalType mapped[] = {0x0011223344556677, 0x8899AABBCCDDEEFF, 0x0123456789ABCDEF};
+        BitVector view(mapped, 176);
+        BitVectorCursor viewCursor(view, 100);
+        bucketA.clone(view);
+        assert(view.getSize() == 176
+            && bucketA.compare(view) == 0
+            && view.template externalOperate<false>(&data, 56, 32)
+            && data == 0xDDEEFF00
+            && viewCursor.read(&data, 64)
+            && data == 0x789ABCDEF8899AAB);
+    }
+
+    test("BitVectorCursor") {
+        BitVectorGuard<BitVector> bitVector;
+        const NativeNaturalType fieldLength = 17, fieldCount = 1<<16;
+        bitVector.setSize(fieldLength*fieldCount);
+        assert(BitVector(bitVector.location).state == BitVector::Fragmented);
+        BitVectorCursor cursor(bitVector);
+        for(NativeNaturalType i = 0; i < fieldCount; ++i)
+            assert(cursor.write(&i, fieldLength));
+        assert(!cursor.write(&cursor, 1) && !cursor.skip(1));
+        cursor.seek(0);
+        for(NativeNaturalType i = 0; i < fieldCount; i += 2) {
+            NativeNaturalType field = 0, data = 0;
+            assert(cursor.read(&field, fieldLength) && field == i && cursor.skip(fieldLength)
+                && bitVector.externalOperate<false>(&data, (i+1)*fieldLength, fieldLength) && data == i+1);
+        }
+        NativeNaturalType fields[3] = {};
+        BitVectorOperation<false> reads[] = {{&fields[0], 60000*fieldLength, fieldLength}, {&fields[1], 7*fieldLength, fieldLength}, {&fields[2], 30000*fieldLength, fieldLength}};
+        assert(bitVector.externalOperateBatch(reads, 3)
+            && fields[0] == 60000 && fields[1] == 7 && fields[2] == 30000);
+        BitVectorOperation<true> writes[] = {{&fields[0], 7*fieldLength, fieldLength}, {&fields[1], fieldCount*fieldLength, 1}};
+        assert(!bitVector.externalOperateBatch(writes, 2)
+            && bitVector.externalOperateBatch(writes, 1)
+            && bitVector.externalOperate<false>(&fields[2], 7*fieldLength, fieldLength) && fields[2] == 60000);
+        assert(bitVector.moveSlice(0, 32768*fieldLength, 16384*fieldLength)
+            && bitVector.getSize() == fieldLength*fieldCount);
+        cursor.seek(0);
+        for(NativeNaturalType i = 0; i < fieldCount; ++i) {
+            NativeNaturalType field = 0, expected = (i < 16384) ? i+32768 : (i < 49152) ? i-16384 : i;
+            assert(cursor.read(&field, fieldLength) && field == ((expected == 7) ? 60000 : expected));
+        }
+        NativeNaturalType spanOffset = 5*fieldLength, spanCount = 0;
+        bool result = bitVector.iterateSpans(spanOffset, 40000*fieldLength, [&](const NativeNaturalType* base, NativeNaturalType offset, NativeNaturalType length) {
+            NativeNaturalType data = 0, expected = 0;
+            bitwiseCopy<-1>(&data, base, 0, offset, min(length, fieldLength));
+            assert(bitVector.externalOperate<false>(&expected, spanOffset, min(length, fieldLength)) && data == expected);
+            spanOffset += length;
+            ++spanCount;
+        });
+        assert(result && spanCount > 1 && spanOffset == 40005*fieldLength);
+        BitVectorGuard<BitVector> clone, secondClone;
+        clone.clone(bitVector);
+        secondClone.clone(bitVector);
+        printStats(true);
+        NativeNaturalType field = 0;
+        assert(BitVector(clone.location).address == BitVector(bitVector.location).address
+            && clone.compare(bitVector) == 0
+            && clone.externalOperate<true>(&spanCount, 0, fieldLength)
+            && BitVector(clone.location).address != BitVector(bitVector.location).address
+            && bitVector.externalOperate<false>(&field, 0, fieldLength) && field == 32768
+            && clone.externalOperate<false>(&field, 0, fieldLength) && field == spanCount
+            && clone.decreaseSize(0, fieldLength) && clone.compare(bitVector) != 0);
+    }
+
+    test("Address Cache") {
+        const NativeNaturalType slotCount = SymbolSpace::addressCacheSize;
+        BitVectorGuard<BitVector> bitVectors[slotCount+1];
+        NativeNaturalType slotOwners[slotCount], a = 0, b = 0;
+        for(NativeNaturalType i = 0; i < slotCount; ++i)
+            slotOwners[i] = slotCount;
+        for(b = 0; b <= slotCount; ++b) {
+            NativeNaturalType& owner = slotOwners[bitVectors[b].location.symbol%slotCount];
+            if(owner < slotCount) {
+                a = owner;
+                break;
+            }
+            owner = b;
+        }
+        BitVectorLocation location = bitVectors[a].location;
+        auto lookup = [&](bool hit) {
+            NativeNaturalType hits = addressCacheHits, misses = addressCacheMisses, address = 0;
+            location.getAddress(address);
+            assert(addressCacheHits == hits+hit && addressCacheMisses == misses+!hit);
+            return address;
+        };
+        NativeNaturalType data = 5, inlineAddress = BitVector::inlineFlag|(static_cast<NativeNaturalType>(8)<<BitVector::inlineBits)|data;
+        bitVectors[a].setSize(8);
+        assert(bitVectors[a].externalOperate<true>(&data, 0, 8)
+            && lookup(true) == inlineAddress);
+        bitVectors[b].setSize(8);
+        assert(lookup(false) == inlineAddress
+            && lookup(true) == inlineAddress);
+        bitVectors[a].setSize(0);
+        assert(lookup(true) == 0 && BitVector(location).state == BitVector::Empty);
+        NativeNaturalType hits = addressCacheHits, misses = addressCacheMisses;
+        addressCacheHits = 0;
+        addressCacheMisses = 0;
+        assert(getAddressCacheHitRate() == 0.0);
+        addressCacheHits = 3;
+        addressCacheMisses = 1;
+        assert(getAddressCacheHitRate() == 75.0);
+        addressCacheHits = hits;
+        addressCacheMisses = misses;
     }
 
     test("BitVectorGuard<DataStructure>") {
@@ -223,6 +518,24 @@ Integer32 main(Integer32 argc, Integer8** argv) {
         assert(vector.getElementCount() == 3);
         vector.setElementCount(0);
         assert(vector.getElementCount() == 0);
+        NativeNaturalType elements[300];
+        for(index = 0; index < 300; ++index)
+            elements[index] = index*3;
+        vector.setElementCount(1000);
+        assert(!vector.fillElements(900, 101, 7)
+            && !vector.fillElements(0, 0, 7)
+            && vector.fillElements(0, 1000, 7)
+            && vector.setElements(500, 300, elements)
+            && vector.getElementAt(499) == 7
+            && vector.getElementAt(800) == 7
+            && vector.getElements(400, 200, elements)
+            && elements[99] == 7 && elements[100] == 0 && elements[199] == 297);
+        index = 0;
+        vector.iterateElements([&](NativeNaturalType element) {
+            assert(element == ((index >= 500 && index < 800) ? (index-500)*3 : 7));
+            ++index;
+        });
+        assert(index == 1000);
     }
 
     test("PairVector") {
@@ -307,6 +620,17 @@ Integer32 main(Integer32 argc, Integer8** argv) {
             assert(element.first == index && element.second == index*2);
             ++index;
         });
+        BitVectorGuard<DataStructure<Vector<ElementType>>> batch;
+        for(NativeNaturalType i = 0; i < 1000; ++i)
+            batch.insertAsLastElement(ElementType{(i*379+256)%1000, ((i*379+256)%1000)*2});
+        batch.insertAsLastElement(ElementType{300, 0});
+        batch.insertAsLastElement(ElementType{1, 0});
+        assert(set.insertElements(batch) == 998 && set.getElementCount() == 1000);
+        index = 0;
+        set.iterateElements([&](Pair<NativeNaturalType, NativeNaturalType> element) {
+            assert(element.first == index && element.second == index*2);
+            ++index;
+        });
     }
 
     test("MetaVector") {
@@ -317,16 +641,63 @@ Integer32 main(Integer32 argc, Integer8** argv) {
         containerVector.increaseSize(containerVector.getChildOffset(0), 32, 0);
         containerVector.insertElementAt(1, 9);
         containerVector.increaseSize(containerVector.getChildOffset(1), 96, 1);
+        for(NativeNaturalType at = 0; at < 3; ++at) {
+            NativeNaturalType data = containerVector.getKeyAt(at)*0x01010101;
+            containerVector.getBitVector().externalOperate<true>(&data, containerVector.getChildOffset(at)+containerVector.getChildLength(at)-32, 32);
+        }
         assert(containerVector.moveElementAt(2, 1) == true
             && containerVector.moveElementAt(0, 1) == true
             && containerVector.getElementCount() == 3
             && containerVector.getKeyAt(0) == 7 && containerVector.getChildLength(0) == 64
             && containerVector.getKeyAt(1) == 5 && containerVector.getChildLength(1) == 32
             && containerVector.getKeyAt(2) == 9 && containerVector.getChildLength(2) == 96);
+        for(NativeNaturalType at = 0; at < 3; ++at) {
+            NativeNaturalType data = 0;
+            containerVector.getBitVector().externalOperate<false>(&data, containerVector.getChildOffset(at)+containerVector.getChildLength(at)-32, 32);
+            assert(data == containerVector.getKeyAt(at)*0x01010101);
+        }
         containerVector.eraseElementAt(1);
         assert(containerVector.getElementCount() == 2
             && containerVector.getKeyAt(0) == 7 && containerVector.getChildLength(0) == 64
             && containerVector.getKeyAt(1) == 9 && containerVector.getChildLength(1) == 96);
+        containerVector.insertElementAt(2, 3);
+        assert(containerVector.moveElementAt(0, 2) == true
+            && containerVector.getKeyAt(0) == 3 && containerVector.getChildLength(0) == 0
+            && containerVector.getKeyAt(1) == 7 && containerVector.getChildLength(1) == 64
+            && containerVector.getKeyAt(2) == 9 && containerVector.getChildLength(2) == 96);
+        BitVectorGuard<DataStructure<MetaVector<NativeNaturalType>>> flatVector;
+        BitVectorGuard<DataStructure<MetaVector<NativeNaturalType, BitVectorContainer, true>>> fenwickVector;
+        for(NativeNaturalType i = 0; i < 500; ++i) {
+            NativeNaturalType elementCount = flatVector.getElementCount(), at = (elementCount == 0) ? 0 : (i*7919)%elementCount;
+            switch((elementCount < 16) ? 0 : i%5) {
+                case 0:
+                    flatVector.insertElementAt(at, i);
+                    fenwickVector.insertElementAt(at, i);
+                    break;
+                case 1:
+                    flatVector.increaseSize(flatVector.getChildOffset(at), 1+i%97, at);
+                    fenwickVector.increaseSize(fenwickVector.getChildOffset(at), 1+i%97, at);
+                    break;
+                case 2: {
+                    NativeNaturalType length = flatVector.getChildLength(at)/2;
+                    flatVector.decreaseSize(flatVector.getChildOffset(at), length, at);
+                    fenwickVector.decreaseSize(fenwickVector.getChildOffset(at), length, at);
+                } break;
+                case 3:
+                    flatVector.moveElementAt((i*104729)%elementCount, at);
+                    fenwickVector.moveElementAt((i*104729)%elementCount, at);
+                    break;
+                case 4:
+                    flatVector.eraseElementAt(at);
+                    fenwickVector.eraseElementAt(at);
+                    break;
+            }
+        }
+        assert(fenwickVector.getElementCount() == flatVector.getElementCount()
+            && fenwickVector.getBitVector().getSize() == flatVector.getBitVector().getSize());
+        for(NativeNaturalType at = 0; at < flatVector.getElementCount(); ++at)
+            assert(fenwickVector.getKeyAt(at) == flatVector.getKeyAt(at)
+                && fenwickVector.getChildBegin(at) == flatVector.getChildBegin(at));
     }
 
     test("MetaSet") {
@@ -368,6 +739,14 @@ Integer32 main(Integer32 argc, Integer8** argv) {
             && pairSet.findElement({1, 1}, firstAt, secondAt) == false
             && pairSet.findElement({3, 5}, firstAt, secondAt) == false
             && pairSet.findElement({3, 3}, firstAt, secondAt) == true && firstAt == 0 && secondAt == 1);
+        BitVectorGuard<DataStructure<Vector<Pair<NativeNaturalType, VoidType>>>> secondKeys;
+        secondKeys.insertAsLastElement(9);
+        secondKeys.insertAsLastElement(11);
+        secondKeys.insertAsLastElement(5);
+        secondKeys.insertAsLastElement(11);
+        assert(pairSet.insertElements(5, secondKeys) == 1
+            && pairSet.getSecondKeyCount(1) == 4
+            && pairSet.eraseElement({5, 11}) == true);
         assert(pairSet.eraseElement({5, 9}) == true);
         NativeNaturalType counter = 1;
         pairSet.iterateFirstKeys([&](NativeNaturalType first) {
@@ -385,6 +764,30 @@ Integer32 main(Integer32 argc, Integer8** argv) {
         });
     }
 
+    test("ContentIndex") {
+        BitVectorGuard<DataStructure<ContentIndex<>>> index;
+        BitVectorGuard<BitVector> contents[5];
+        NativeNaturalType data[] = {5, 1, 2, 1, 3, 1, 3, 1, 4};
+        contents[0].setSize(64);
+        contents[0].externalOperate<true>(&data[0], 0, 64);
+        for(NativeNaturalType i = 1; i < 5; ++i) {
+            contents[i].setSize(128);
+            contents[i].externalOperate<true>(&data[i*2-1], 0, 128);
+        }
+        Symbol symbols[5];
+        for(NativeNaturalType i = 0; i < 5; ++i)
+            symbols[i] = contents[i].location.symbol;
+        NativeNaturalType at;
+        for(NativeNaturalType i = 3; i > 0; --i)
+            assert(index.insertContent(symbols[i-1]));
+        Symbol duplicate = symbols[3];
+        assert(!index.insertContent(duplicate) && duplicate == symbols[2]
+            && index.getElementCount() == 3
+            && index.findKey(symbols[3], at) && index.getKeyAt(at) == symbols[2] && at == 2
+            && index.findKey(symbols[0], at) && at == 0
+            && !index.findKey(symbols[4], at) && at == 3);
+    }
+
     test("BitMap fillSlice and clearSlice") {
         BitVectorGuard<DataStructure<BitMap<>>> bitMap;
         NativeNaturalType sliceIndex, dstOffset;
@@ -579,6 +982,7 @@ Integer32 main(Integer32 argc, Integer8** argv) {
     }
 
     test("unloadStorage") {
+        printStats(true);
         unloadStorage();
     }
 